@@ -0,0 +1,102 @@
+#ifndef bench_
+#define bench_
+
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "../src/workload.h"
+
+// key generators of experiments/balls_into_bins
+
+std::vector<uint32_t> create_range_sequence(int num_elements)
+{
+    std::vector<uint32_t> elems(num_elements);
+    std::iota(elems.begin(), elems.end(), 0);
+    return elems;
+}
+
+std::vector<uint32_t> create_divides_by_sequence(int num_elements, int divisor)
+{
+    std::vector<uint32_t> elems(num_elements);
+    uint32_t num = 0;
+
+    for (int i = 0; i < num_elements; i++)
+    {
+        elems[i] = num;
+        num += divisor;
+    }
+
+    return elems;
+}
+
+// distinct keys of one of the generators above ("range" or "divides_by") or of DistinctKeys ("random")
+std::vector<uint32_t> create_keys(const std::string &generator, int num_elements)
+{
+    if (generator == "range")
+    {
+        return create_range_sequence(num_elements);
+    }
+    if (generator == "divides_by")
+    {
+        return create_divides_by_sequence(num_elements, 7);
+    }
+    return DistinctKeys<uint32_t>(42).generate(0, num_elements);
+}
+
+// keeps the compiler from removing a computation whose result is otherwise unused
+template <typename T>
+void do_not_optimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// million operations per second of f, which performs num_operations operations
+template <typename F>
+double measure_mops(long long num_operations, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double, std::micro> microseconds = std::chrono::steady_clock::now() - start;
+    return num_operations / microseconds.count();
+}
+
+// Timestamps for a single operation: the fences keep the operation from moving before begin or after end.
+// The result is in TSC cycles on x86 (a constant rate, independent of frequency scaling) and in nanoseconds
+// elsewhere.
+inline uint64_t cycles_begin()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+inline uint64_t cycles_end()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int aux;
+    const uint64_t cycles = __rdtscp(&aux);
+    _mm_lfence();
+    return cycles;
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+double median(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+#endif
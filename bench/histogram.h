@@ -0,0 +1,101 @@
+#ifndef histogram_
+#define histogram_
+
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <bit>
+
+// Histogram of latencies with a bounded relative error (HDR style): values below 64 have a bucket each, above
+// that every power of two range is split into 32 buckets, so a bucket is at most 1/32 of its values wide.
+// Recording is a few instructions, so a histogram can be filled inside a timed loop.
+class LatencyHistogram
+{
+public:
+    void record(uint64_t value)
+    {
+        ++counts[bucket(value)];
+        ++total;
+        largest = std::max(largest, value);
+    }
+
+    // smallest value (rounded up to the end of its bucket) that at least the fraction p of the values don't exceed
+    uint64_t percentile(double p) const
+    {
+        const uint64_t rank = std::max<uint64_t>(1, p * total + 0.5);
+        uint64_t seen = 0;
+        for (int i = 0; i < num_buckets; ++i)
+        {
+            seen += counts[i];
+            if (seen >= rank)
+            {
+                return std::min(bucket_end(i), largest);
+            }
+        }
+        return largest;
+    }
+
+    // number of values in the bucket of value and above
+    uint64_t count_at_least(uint64_t value) const
+    {
+        uint64_t count = 0;
+        for (int i = bucket(value); i < num_buckets; ++i)
+        {
+            count += counts[i];
+        }
+        return count;
+    }
+
+    uint64_t max() const
+    {
+        return largest;
+    }
+
+    uint64_t count() const
+    {
+        return total;
+    }
+
+    void merge(const LatencyHistogram &other)
+    {
+        for (int i = 0; i < num_buckets; ++i)
+        {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        largest = std::max(largest, other.largest);
+    }
+
+    void reset()
+    {
+        counts.fill(0);
+        total = 0;
+        largest = 0;
+    }
+
+private:
+    static constexpr int sub_bucket_bits = 5;
+    static constexpr int sub_buckets = 1 << sub_bucket_bits;
+    // values below 2 * sub_buckets, then sub_buckets buckets for each of the remaining 58 powers of two
+    static constexpr int num_buckets = (64 - sub_bucket_bits) * sub_buckets + sub_buckets;
+
+    std::array<uint64_t, num_buckets> counts{};
+    uint64_t total = 0;
+    uint64_t largest = 0;
+
+    static int bucket(uint64_t value)
+    {
+        const int shift = std::max(0, int(std::bit_width(value)) - sub_bucket_bits - 1);
+        return shift * sub_buckets + int(value >> shift);
+    }
+
+    // largest value of bucket i
+    static uint64_t bucket_end(int i)
+    {
+        const int shift = std::max(0, i / sub_buckets - 1);
+        const uint64_t first = uint64_t(i - shift * sub_buckets) << shift;
+        return first + (uint64_t(1) << shift) - 1;
+    }
+};
+
+#endif
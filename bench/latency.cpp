@@ -0,0 +1,236 @@
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "histogram.h"
+#include "../src/backyard.h"
+
+constexpr int num_bins = 1 << 14;
+constexpr int bin_capacity = 8;
+constexpr int size_cuckoo_tables = 1 << 14;
+constexpr int n_queue = 1000;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 1000;
+constexpr int n_cdm = 1000;
+constexpr int k_cdm = 20;
+constexpr int num_insert_loop_iterations = 16;
+constexpr double load_factor = 0.9;
+// an eviction walk that already spans more steps than two inserts perform counts as long
+constexpr int long_walk = 2 * num_insert_loop_iterations;
+
+using Set = BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                  num_elems_cdm, n_cdm, k_cdm>;
+
+enum Operation
+{
+    op_insert,
+    op_contains_hit,
+    op_contains_miss,
+    op_remove,
+    num_operations
+};
+const std::array<std::string, num_operations> operation_names{"insert", "contains_hit", "contains_miss", "remove"};
+
+// what else happened during an operation, if several things happened the last one in this order is recorded
+enum Cause
+{
+    cause_none,
+    cause_long_eviction_walk,
+    cause_cdm_rebuild,
+    cause_queue_rebuild,
+    num_causes
+};
+const std::array<std::string, num_causes> cause_names{"none", "long_eviction_walk", "cdm_rebuild", "queue_rebuild"};
+
+// times a single operation and records it in the histogram of its cause
+class Recorder
+{
+public:
+    explicit Recorder(const Set &set) : set(set)
+    {
+    }
+
+    template <typename F>
+    void measure(Operation operation, F f)
+    {
+        const int queue_rebuilds = set.queue.rebuilds();
+        const int cdm_rebuilds = set.cdm.rebuilds();
+        const int walk_before = set.cdm.size();
+        const long long evictions_before = set.cdm.inserts();
+        const uint64_t begin = cycles_begin();
+        f();
+        const uint64_t cycles = cycles_end() - begin;
+
+        Cause cause = cause_none;
+        if (set.queue.rebuilds() != queue_rebuilds)
+        {
+            cause = cause_queue_rebuild;
+        }
+        else if (set.cdm.rebuilds() != cdm_rebuilds)
+        {
+            cause = cause_cdm_rebuild;
+        }
+        else if (operation == op_insert && set.cdm.inserts() != evictions_before &&
+                 walk_before + (set.cdm.inserts() - evictions_before) > long_walk)
+        {
+            // the insert evicted elements of a walk that spans the evictions before it (the cdm holds those of the
+            // walk in progress) and its own, lookups and removals never advance a walk
+            cause = cause_long_eviction_walk;
+        }
+        histograms[operation][cause].record(cycles);
+        round_histograms[operation].record(cycles);
+    }
+
+    // histograms of the operations since the last call
+    std::array<LatencyHistogram, num_operations> end_round()
+    {
+        std::array<LatencyHistogram, num_operations> round = round_histograms;
+        for (LatencyHistogram &histogram : round_histograms)
+        {
+            histogram.reset();
+        }
+        return round;
+    }
+
+    // all operations of one type
+    LatencyHistogram total(Operation operation) const
+    {
+        LatencyHistogram histogram;
+        for (const LatencyHistogram &of_cause : histograms[operation])
+        {
+            histogram.merge(of_cause);
+        }
+        return histogram;
+    }
+
+    const LatencyHistogram &of_cause(Operation operation, Cause cause) const
+    {
+        return histograms[operation][cause];
+    }
+
+private:
+    const Set &set;
+    std::array<std::array<LatencyHistogram, num_causes>, num_operations> histograms;
+    std::array<LatencyHistogram, num_operations> round_histograms;
+};
+
+// cost of the timestamps themselves, contained in every measurement
+uint64_t timer_overhead()
+{
+    LatencyHistogram histogram;
+    for (int i = 0; i < 100000; ++i)
+    {
+        const uint64_t begin = cycles_begin();
+        histogram.record(cycles_end() - begin);
+    }
+    return histogram.percentile(0.5);
+}
+
+void write_percentiles(std::ostream &out, const LatencyHistogram &histogram)
+{
+    out << histogram.count() << "," << histogram.percentile(0.5) << "," << histogram.percentile(0.99) << ","
+        << histogram.percentile(0.999) << "," << histogram.max();
+}
+
+int main(int argc, char **argv)
+{
+    // rounds of churn after filling the set, a round performs as many steps as the set holds elements
+    const int num_rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+
+    std::ofstream summary_file("latency.csv");
+    std::ofstream soak_file("latency_soak.csv");
+    if (!summary_file.is_open() || !soak_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    summary_file << "operation,cause,count,p50_cycles,p99_cycles,p999_cycles,max_cycles,count_above_total_p999\n";
+    soak_file << "round,operation,count,p50_cycles,p99_cycles,p999_cycles,max_cycles\n";
+
+    const int num_elements = load_factor * num_bins * bin_capacity;
+    // present keys are in the set, absent ones never are at the same time
+    const DistinctKeys<uint32_t> keys(42);
+    std::vector<uint32_t> present = keys.generate(0, num_elements);
+    std::vector<uint32_t> absent = keys.generate(num_elements, num_elements);
+
+    std::unique_ptr<Set> set = std::make_unique<Set>(num_insert_loop_iterations);
+    Recorder recorder(*set);
+    std::cout << "timer overhead " << timer_overhead() << " cycles (included in all numbers)\n";
+
+    for (uint32_t key : present)
+    {
+        recorder.measure(op_insert, [&]
+                         { set->insert(key); });
+    }
+    recorder.end_round();
+
+    // churn: replace a random element by a random absent one, so the load stays the same
+    std::mt19937_64 gen(7);
+    std::uniform_int_distribution<int> present_index(0, num_elements - 1);
+    std::uniform_int_distribution<int> absent_index(0, absent.size() - 1);
+    bool found = false;
+    for (int round = 0; round < num_rounds; ++round)
+    {
+        for (int step = 0; step < num_elements; ++step)
+        {
+            const uint32_t hit = present[present_index(gen)];
+            const uint32_t miss = absent[absent_index(gen)];
+            const int i = present_index(gen);
+            const int j = absent_index(gen);
+            recorder.measure(op_contains_hit, [&]
+                             { found ^= set->contains(hit); });
+            recorder.measure(op_contains_miss, [&]
+                             { found ^= set->contains(miss); });
+            recorder.measure(op_remove, [&]
+                             { found ^= set->remove(present[i]); });
+            recorder.measure(op_insert, [&]
+                             { set->insert(absent[j]); });
+            std::swap(present[i], absent[j]);
+        }
+        const std::array<LatencyHistogram, num_operations> histograms = recorder.end_round();
+        std::cout << "round " << round;
+        for (int operation = 0; operation < num_operations; ++operation)
+        {
+            soak_file << round << "," << operation_names[operation] << ",";
+            write_percentiles(soak_file, histograms[operation]);
+            soak_file << "\n";
+            std::cout << " " << operation_names[operation] << " p99.9=" << histograms[operation].percentile(0.999)
+                      << " max=" << histograms[operation].max();
+        }
+        std::cout << "\n";
+    }
+    do_not_optimize(found);
+
+    for (int operation = 0; operation < num_operations; ++operation)
+    {
+        const Operation op = Operation(operation);
+        const LatencyHistogram total = recorder.total(op);
+        const uint64_t p999 = total.percentile(0.999);
+        summary_file << operation_names[op] << ",all,";
+        write_percentiles(summary_file, total);
+        summary_file << "," << total.count_at_least(p999) << "\n";
+        std::cout << operation_names[op] << " p50=" << total.percentile(0.5) << " p99=" << total.percentile(0.99)
+                  << " p99.9=" << p999 << " max=" << total.max() << " cycles\n";
+        // outliers: operations at or above the p99.9 of all operations of this type, split by cause
+        for (int cause = 0; cause < num_causes; ++cause)
+        {
+            const LatencyHistogram &histogram = recorder.of_cause(op, Cause(cause));
+            summary_file << operation_names[op] << "," << cause_names[cause] << ",";
+            write_percentiles(summary_file, histogram);
+            summary_file << "," << histogram.count_at_least(p999) << "\n";
+            if (histogram.count_at_least(p999) > 0)
+            {
+                std::cout << "    " << histogram.count_at_least(p999) << " outliers with " << cause_names[cause]
+                          << " (max " << histogram.max() << ")\n";
+            }
+        }
+    }
+
+    return 0;
+}
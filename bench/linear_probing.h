@@ -0,0 +1,95 @@
+#ifndef linear_probing_
+#define linear_probing_
+
+#include <cstdint>
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+// Baseline for the benchmarks: open addressing with linear probing, a fixed number of slots (rounded up to a
+// power of two) and multiplicative (Fibonacci) hashing. Remove shifts later elements of the probe sequence back,
+// so there are no tombstones. Inserting into a full table doesn't terminate.
+template <typename T>
+class LinearProbingSet
+{
+public:
+    explicit LinearProbingSet(std::size_t num_slots)
+        : slots(std::bit_ceil(std::max<std::size_t>(num_slots, 2))), occupied(slots.size(), 0),
+          shift(64 - std::countr_zero(slots.size())), mask(slots.size() - 1)
+    {
+    }
+
+    bool insert(const T &item)
+    {
+        std::size_t i = home(item);
+        while (occupied[i])
+        {
+            if (slots[i] == item)
+            {
+                return false;
+            }
+            i = (i + 1) & mask;
+        }
+        slots[i] = item;
+        occupied[i] = true;
+        ++_size;
+        return true;
+    }
+
+    bool contains(const T &item) const
+    {
+        for (std::size_t i = home(item); occupied[i]; i = (i + 1) & mask)
+        {
+            if (slots[i] == item)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool remove(const T &item)
+    {
+        std::size_t i = home(item);
+        while (occupied[i] && slots[i] != item)
+        {
+            i = (i + 1) & mask;
+        }
+        if (!occupied[i])
+        {
+            return false;
+        }
+        // move back every following element whose home slot doesn't lie between the hole and itself
+        std::size_t hole = i;
+        for (std::size_t j = (i + 1) & mask; occupied[j]; j = (j + 1) & mask)
+        {
+            if (((j - home(slots[j])) & mask) >= ((j - hole) & mask))
+            {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        occupied[hole] = false;
+        --_size;
+        return true;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+
+private:
+    std::vector<T> slots;
+    std::vector<uint8_t> occupied;
+    int shift;
+    std::size_t mask;
+    std::size_t _size = 0;
+
+    std::size_t home(const T &item) const
+    {
+        return (uint64_t(item) * 0x9e3779b97f4a7c15ULL) >> shift;
+    }
+};
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef perf_counters_
+#define perf_counters_
+
+#include <cstdint>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum PerfEvent
+{
+    perf_cycles,
+    perf_instructions,
+    perf_l1d_misses,
+    perf_llc_misses,
+    perf_branch_misses,
+    perf_dtlb_misses,
+    num_perf_events
+};
+
+// Hardware counters of the calling thread (user space only) through perf_event_open. Every counter is opened on
+// its own, counters the machine or the kernel doesn't provide (virtual machines, containers,
+// perf_event_paranoid > 2, other operating systems) are left out and read as std::nullopt, the others still
+// work. If the kernel multiplexes the counters the values are scaled to the whole measured interval.
+class PerfCounters
+{
+public:
+    using Values = std::array<std::optional<double>, num_perf_events>;
+
+    PerfCounters()
+    {
+        fds.fill(-1);
+#if defined(__linux__)
+        // type, config of every PerfEvent
+        const std::array<std::array<uint64_t, 2>, num_perf_events> events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, cache_event(PERF_COUNT_HW_CACHE_DTLB)},
+        }};
+        for (int event = 0; event < num_perf_events; ++event)
+        {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = events[event][0];
+            attributes.config = events[event][1];
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            fds[event] = syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        }
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available(PerfEvent event) const
+    {
+        return fds[event] >= 0;
+    }
+
+    // names of the counters that can't be read, empty if all work
+    std::string unavailable() const
+    {
+        static constexpr std::array<const char *, num_perf_events> names{
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses"};
+        std::string result;
+        for (int event = 0; event < num_perf_events; ++event)
+        {
+            if (!available(PerfEvent(event)))
+            {
+                result += (result.empty() ? "" : ", ") + std::string(names[event]);
+            }
+        }
+        return result;
+    }
+
+    void start()
+    {
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // counts since start
+    Values stop()
+    {
+        Values values;
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (int event = 0; event < num_perf_events; ++event)
+        {
+            // value, time enabled, time running
+            uint64_t data[3];
+            if (fds[event] >= 0 && read(fds[event], data, sizeof(data)) == sizeof(data) && data[2] > 0)
+            {
+                values[event] = double(data[0]) * data[1] / data[2];
+            }
+        }
+#endif
+        return values;
+    }
+
+private:
+    std::array<int, num_perf_events> fds;
+
+#if defined(__linux__)
+    static constexpr uint64_t cache_event(uint64_t cache)
+    {
+        return cache | PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    }
+#endif
+};
+
+#endif
@@ -0,0 +1,300 @@
+#include <cstdint>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "bench.h"
+#include "linear_probing.h"
+#include "perf_counters.h"
+#include "../src/backyard.h"
+#include "../src/quotient_bin.h"
+#include "../src/tagged_bin.h"
+
+// all sets have the same number of slots in their first level, so a load factor means the same for all of them
+constexpr int num_slots = 1 << 17;
+// large enough for the overflow of 4 element bins at load factor 0.95 (about 18% of the keys)
+constexpr int size_cuckoo_tables = 1 << 15;
+constexpr int n_queue = 1000;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 1000;
+constexpr int n_cdm = 1000;
+constexpr int k_cdm = 20;
+constexpr int num_insert_loop_iterations = 16;
+constexpr int num_repetitions = 5;
+
+template <int bin_capacity, typename Bins = SimpleBinCollection<uint32_t, num_slots / bin_capacity, bin_capacity>>
+using Backyard = BackyardCuckooHashing<uint32_t, num_slots / bin_capacity, bin_capacity, size_cuckoo_tables, n_queue,
+                                       k_queue, num_elems_cdm, n_cdm, k_cdm, Bins>;
+
+// same interface as the other sets
+class StdSet
+{
+public:
+    explicit StdSet(int num_elements)
+    {
+        set.reserve(num_elements);
+    }
+
+    void insert(uint32_t item)
+    {
+        set.insert(item);
+    }
+
+    bool contains(uint32_t item) const
+    {
+        return set.contains(item);
+    }
+
+    bool remove(uint32_t item)
+    {
+        return set.erase(item);
+    }
+
+private:
+    std::unordered_set<uint32_t> set;
+};
+
+const std::vector<std::string> operations{"insert", "contains_hit", "contains_miss", "contains_zipf", "mixed",
+                                          "remove"};
+
+struct Measurement
+{
+    double mops;
+    // hardware counters divided by the number of operations
+    PerfCounters::Values per_operation;
+};
+
+template <typename F>
+Measurement measure(PerfCounters &counters, long long num_operations, F f)
+{
+    counters.start();
+    const double mops = measure_mops(num_operations, f);
+    PerfCounters::Values values = counters.stop();
+    for (std::optional<double> &value : values)
+    {
+        if (value.has_value())
+        {
+            *value /= num_operations;
+        }
+    }
+    return {mops, values};
+}
+
+// Mops/s of every operation in one run: insert present keys, look all of them up (in another order), look up
+// absent keys, skewed lookups (90% hits, Zipf distributed with exponent 0.99 over the present keys), a mix that
+// keeps the size constant (per step one hit, one miss, one remove, one insert), then remove all keys
+template <typename Set>
+std::vector<Measurement> run_workloads(Set &set, PerfCounters &counters, const std::vector<uint32_t> &present,
+                                       const std::vector<uint32_t> &absent)
+{
+    const long long n = present.size();
+    std::vector<uint32_t> lookups = present;
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(7));
+    std::vector<uint32_t> keys = present;
+    keys.insert(keys.end(), absent.begin(), absent.end());
+    const std::vector<uint32_t> skewed_lookups =
+        LookupStream<std::span<const uint32_t>>(keys, n, absent.size(), 0.9, ZipfDistribution(n, 0.99), 7)
+            .generate(0, n);
+    std::vector<Measurement> mops;
+    long long found = 0;
+
+    mops.push_back(measure(counters, n, [&]
+                           {
+        for (uint32_t key : present)
+        {
+            set.insert(key);
+        } }));
+    mops.push_back(measure(counters, n, [&]
+                           {
+        for (uint32_t key : lookups)
+        {
+            found += set.contains(key);
+        } }));
+    mops.push_back(measure(counters, n, [&]
+                           {
+        for (uint32_t key : absent)
+        {
+            found += set.contains(key);
+        } }));
+    mops.push_back(measure(counters, n, [&]
+                           {
+        for (uint32_t key : skewed_lookups)
+        {
+            found += set.contains(key);
+        } }));
+    mops.push_back(measure(counters, 2 * n, [&]
+                           {
+        for (long long i = 0; i < n / 2; ++i)
+        {
+            found += set.contains(lookups[n - 1 - i]);
+            found += set.contains(absent[n - 1 - i]);
+            found += set.remove(present[i]);
+            set.insert(absent[i]);
+        } }));
+    mops.push_back(measure(counters, n, [&]
+                           {
+        for (long long i = n / 2; i < n; ++i)
+        {
+            found += set.remove(present[i]);
+        }
+        for (long long i = 0; i < n / 2; ++i)
+        {
+            found += set.remove(absent[i]);
+        } }));
+    do_not_optimize(found);
+    return mops;
+}
+
+// median over the repetitions, empty if the counter isn't available
+std::optional<double> median_counter(const std::vector<std::vector<Measurement>> &repetitions, std::size_t op,
+                                     PerfEvent event)
+{
+    std::vector<double> values;
+    for (const std::vector<Measurement> &repetition : repetitions)
+    {
+        if (repetition[op].per_operation[event].has_value())
+        {
+            values.push_back(*repetition[op].per_operation[event]);
+        }
+    }
+    return values.empty() ? std::nullopt : std::optional<double>(median(values));
+}
+
+void write_rows(std::ofstream &csv_file, const std::string &name, const std::string &generator, int bin_capacity,
+                double load_factor, const std::vector<std::vector<Measurement>> &repetitions)
+{
+    std::cout << name << " keys=" << generator << " bin_capacity=" << bin_capacity << " load_factor=" << load_factor
+              << "\n   ";
+    for (std::size_t op = 0; op < operations.size(); ++op)
+    {
+        std::vector<double> mops;
+        for (const std::vector<Measurement> &repetition : repetitions)
+        {
+            mops.push_back(repetition[op].mops);
+        }
+        std::array<std::optional<double>, num_perf_events> counters;
+        for (int event = 0; event < num_perf_events; ++event)
+        {
+            counters[event] = median_counter(repetitions, op, PerfEvent(event));
+        }
+        std::optional<double> ipc;
+        if (counters[perf_cycles].has_value() && counters[perf_instructions].has_value())
+        {
+            ipc = *counters[perf_instructions] / *counters[perf_cycles];
+        }
+
+        csv_file << name << "," << generator << "," << bin_capacity << "," << load_factor << "," << operations[op]
+                 << "," << median(mops);
+        // unavailable counters are left empty
+        for (const std::optional<double> &value : {ipc, counters[perf_cycles], counters[perf_instructions],
+                                                    counters[perf_l1d_misses], counters[perf_llc_misses],
+                                                    counters[perf_branch_misses], counters[perf_dtlb_misses]})
+        {
+            csv_file << "," << (value.has_value() ? std::to_string(*value) : "");
+        }
+        csv_file << "\n";
+
+        std::cout << " " << operations[op] << "=" << median(mops);
+        if (ipc.has_value())
+        {
+            std::cout << " (ipc " << *ipc << ")";
+        }
+        if (counters[perf_l1d_misses].has_value() && counters[perf_llc_misses].has_value())
+        {
+            std::cout << " (l1d/llc misses per op " << *counters[perf_l1d_misses] << "/"
+                      << *counters[perf_llc_misses] << ")";
+        }
+    }
+    std::cout << " Mops/s\n";
+}
+
+template <typename Set>
+void benchmark(std::ofstream &csv_file, PerfCounters &counters, const std::string &name,
+               std::function<std::unique_ptr<Set>()> make_set, const std::string &generator, int bin_capacity,
+               double load_factor, const std::vector<uint32_t> &present, const std::vector<uint32_t> &absent)
+{
+    std::vector<std::vector<Measurement>> repetitions;
+    for (int i = 0; i < num_repetitions; ++i)
+    {
+        std::unique_ptr<Set> set = make_set();
+        repetitions.push_back(run_workloads(*set, counters, present, absent));
+    }
+    write_rows(csv_file, name, generator, bin_capacity, load_factor, repetitions);
+}
+
+template <int bin_capacity, typename Bins = SimpleBinCollection<uint32_t, num_slots / bin_capacity, bin_capacity>>
+void benchmark_backyard(std::ofstream &csv_file, PerfCounters &counters, const std::string &name,
+                        const std::string &generator, double load_factor, const std::vector<uint32_t> &present,
+                        const std::vector<uint32_t> &absent)
+{
+    benchmark<Backyard<bin_capacity, Bins>>(
+        csv_file, counters, name, []
+        { return std::make_unique<Backyard<bin_capacity, Bins>>(num_insert_loop_iterations); },
+        generator, bin_capacity, load_factor, present, absent);
+}
+
+int main()
+{
+    // Open the output CSV file
+    std::ofstream csv_file("throughput.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "implementation,keys,bin_capacity,load_factor,operation,mops,ipc,cycles_per_op,instructions_per_op,"
+                "l1d_misses_per_op,llc_misses_per_op,branch_misses_per_op,dtlb_misses_per_op\n";
+
+    PerfCounters counters;
+    if (!counters.unavailable().empty())
+    {
+        std::cout << "hardware counters not available: " << counters.unavailable() << "\n";
+    }
+
+    std::vector<double> load_factors{0.5, 0.8, 0.9, 0.95};
+    for (const std::string generator : {"random", "range", "divides_by"})
+    {
+        for (double load_factor : load_factors)
+        {
+            const int num_elements = load_factor * num_slots;
+            // the first half of the keys is inserted, the second half is used for unsuccessful lookups
+            const std::vector<uint32_t> keys = create_keys(generator, 2 * num_elements);
+            const std::vector<uint32_t> present(keys.begin(), keys.begin() + num_elements);
+            const std::vector<uint32_t> absent(keys.begin() + num_elements, keys.end());
+
+            benchmark_backyard<4>(csv_file, counters, "backyard", generator, load_factor, present, absent);
+            benchmark_backyard<8>(csv_file, counters, "backyard", generator, load_factor, present, absent);
+            benchmark_backyard<16>(csv_file, counters, "backyard", generator, load_factor, present, absent);
+            // other bin layouts
+            constexpr int num_bins = num_slots / 8;
+            benchmark_backyard<8, SimpleBinCollection<uint32_t, num_bins, 8, 2>>(
+                csv_file, counters, "backyard_two_choice_bins", generator, load_factor, present, absent);
+            benchmark_backyard<8, QuotientBinCollection<uint32_t, num_bins, 8>>(
+                csv_file, counters, "backyard_quotient_bins", generator, load_factor, present, absent);
+            benchmark_backyard<8, TaggedBinCollection<uint32_t, num_bins, 8>>(
+                csv_file, counters, "backyard_tagged_bins", generator, load_factor, present, absent);
+            // the baselines have no bins, their bin capacity is written as 0
+            benchmark<StdSet>(
+                csv_file, counters, "unordered_set", [num_elements]
+                { return std::make_unique<StdSet>(num_elements); },
+                generator, 0, load_factor, present, absent);
+            benchmark<LinearProbingSet<uint32_t>>(
+                csv_file, counters, "linear_probing", []
+                { return std::make_unique<LinearProbingSet<uint32_t>>(num_slots); },
+                generator, 0, load_factor, present, absent);
+        }
+    }
+
+    // Close the file
+    csv_file.close();
+
+    return 0;
+}
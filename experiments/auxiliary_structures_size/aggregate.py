@@ -0,0 +1,15 @@
+import sys
+
+# the plot scripts are run from the root of the repository
+sys.path.append("experiments")
+from columnar import read_columns
+
+folder = "experiments/auxiliary_structures_size/"
+
+
+def read_aggregate(bin_capacity):
+    # mean, max and std over the repetitions of every size after every insert, written by main.cpp
+    data = read_columns(folder + "data/data_bin_cap_{}.bin".format(bin_capacity))
+    # 0 stands for the adaptive policy
+    data["insert_loop_iterations"] = data["insert_loop_iterations"].astype(str).replace("0", "adaptive_2_20")
+    return data
@@ -2,91 +2,233 @@
 #include <random>
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
-#include <numeric>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <utility>
-#include <fstream>
-#include <unordered_set>
 #include "../../src/backyard.h"
+#include "../../src/workload.h"
+#include "../columnar.h"
 
-std::vector<uint32_t> create_random_input_sequence(int num_elements, int seed)
+// Runs every configuration (bin capacity) and repetition on all cores and writes, per configuration, the mean,
+// max and standard deviation over the repetitions of every size after every insert to
+// data/data_bin_cap_<bin capacity>.bin (read with experiments/columnar.py, see the plot scripts).
+// usage: main [num_repetitions] [bin capacities...]   (default: 100 repetitions of all bin capacities)
+
+constexpr std::array<int, 11> bin_capacities{1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+// num overflowing elements * 2/3 from plot_tornado_random.png in balls into bins experiment
+constexpr std::array<int, 11> sizes_cuckoo_tables{2453, 1804, 1303, 1071, 930, 762, 661, 542, 702, 384, 333};
+constexpr int num_insertions = 10000;
+// max load factor 3/4 of cuckoo tables (total space) based on balls into bins experiment
+// (all overflowing elements would take up 75% of total space in cuckoo tables)
+constexpr int n_queue = 200;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 500;
+constexpr int n_cdm = 200;
+constexpr int k_cdm = 20;
+
+// 0 stands for the adaptive policy
+const std::vector<int> insert_loop_iterations{2, 4, 8, 12, 16, 20, 0};
+// adaptive policy: 2 iterations while the queue is short, growing linearly up to 20 between the watermarks
+constexpr int adaptive_min_iterations = 2;
+constexpr int adaptive_max_iterations = 20;
+constexpr int adaptive_queue_low_watermark = 8;
+constexpr int adaptive_queue_high_watermark = 64;
+
+enum Metric
+{
+    bins_size,
+    queue_size,
+    cdm_size,
+    cuckoo_tables_size,
+    num_metrics
+};
+const std::array<std::string, num_metrics> metric_names{"bins_size", "queue_size", "cdm_size", "cuckoo_tables_size"};
+
+// sizes after every insert of one repetition, indexed by metric, iteration setting and time step
+using Trace = std::vector<int32_t>;
+
+std::size_t trace_index(int metric, std::size_t setting, int time_step)
+{
+    return (metric * insert_loop_iterations.size() + setting) * num_insertions + time_step;
+}
+
+// running sum, sum of squares and max of every size over the repetitions of one configuration
+class Aggregate
 {
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<uint32_t> dis(0, UINT32_MAX);
-    std::unordered_set<uint32_t> elems;
+public:
+    Aggregate()
+        : sums(num_metrics * insert_loop_iterations.size() * num_insertions, 0),
+          squares(sums.size(), 0),
+          maxima(sums.size(), 0)
+    {
+    }
 
-    for (int i = 0; i < num_elements; ++i)
+    void add(const Trace &trace)
     {
-        uint32_t value = dis(gen);
-        while (elems.find(value) != elems.end())
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t i = 0; i < trace.size(); ++i)
         {
-            value = dis(gen);
+            sums[i] += trace[i];
+            squares[i] += double(trace[i]) * trace[i];
+            maxima[i] = std::max(maxima[i], trace[i]);
         }
-        elems.insert(value);
+        ++repetitions;
     }
 
-    return std::vector<uint32_t>(elems.begin(), elems.end());
-}
+    void write(const std::string &path, int bin_capacity, int size_cuckoo_tables) const
+    {
+        const std::size_t num_rows = insert_loop_iterations.size() * num_insertions;
+        std::vector<int32_t> iterations, time_steps;
+        for (int setting : insert_loop_iterations)
+        {
+            for (int j = 0; j < num_insertions; ++j)
+            {
+                iterations.push_back(setting);
+                time_steps.push_back(j);
+            }
+        }
+        ColumnarTable table;
+        table.add_column("bin_capacity", std::vector<int32_t>(num_rows, bin_capacity));
+        table.add_column("max_size_cuckoo_tables", std::vector<int32_t>(num_rows, size_cuckoo_tables));
+        table.add_column("insert_loop_iterations", iterations);
+        table.add_column("time_step", time_steps);
+        for (int metric = 0; metric < num_metrics; ++metric)
+        {
+            std::vector<double> means, deviations;
+            std::vector<int32_t> max;
+            for (std::size_t i = metric * num_rows; i < (metric + 1) * num_rows; ++i)
+            {
+                const double mean = sums[i] / repetitions;
+                means.push_back(mean);
+                // sample standard deviation, like pandas
+                deviations.push_back(repetitions > 1 ? std::sqrt(std::max(0.0, (squares[i] - repetitions * mean * mean) /
+                                                                                       (repetitions - 1)))
+                                                     : 0.0);
+                max.push_back(maxima[i]);
+            }
+            table.add_column(metric_names[metric] + "_mean", means);
+            table.add_column(metric_names[metric] + "_max", max);
+            table.add_column(metric_names[metric] + "_std", deviations);
+        }
+        table.write(path);
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<double> sums;
+    std::vector<double> squares;
+    std::vector<int32_t> maxima;
+    int repetitions = 0;
+};
 
-int main()
+// one repetition of one configuration: every iteration setting inserts the same input sequence
+template <int experiment>
+Trace run_repetition(int seed)
 {
-    // to reproduce data from plots simply run this file for desired experiment run
-    // (experiment = 0 ==> bin_capacity = 1, experiment = 1 ==> bin_capacity = 2, etc.)
-    constexpr int experiment = 10;
-    constexpr std::array<int, 11> bin_capacities{1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
-    // num overflowing elements * 2/3 from plot_tornado_random.png in balls into bins experiment
-    constexpr std::array<int, 11> sizes_cuckoo_tables{2453, 1804, 1303, 1071, 930, 762, 661, 542, 702, 384, 333};
-    constexpr int num_insertions = 10000;
-    constexpr int num_repetitions = 100;
     constexpr int bin_capacity = bin_capacities[experiment];
     constexpr int num_bins = num_insertions / bin_capacity;
     constexpr int size_cuckoo_tables = sizes_cuckoo_tables[experiment];
-    // max load factor 3/4 of cuckoo tables (total space) based on balls into bins experiment
-    // (all overflowing elements would take up 75% of total space in cuckoo tables)
-    constexpr int n_queue = 200;
-    constexpr int k_queue = 20;
-    constexpr int num_elems_cdm = 500;
-    constexpr int n_cdm = 200;
-    constexpr int k_cdm = 20;
-
-    // Open the output CSV file
-    std::string file_name = "data/data_bin_cap_";
-    file_name += std::to_string(bin_capacity);
-    file_name += ".csv";
-    std::ofstream csv_file(file_name);
-    if (!csv_file.is_open())
+    using Backyard = BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                           num_elems_cdm, n_cdm, k_cdm>;
+
+    // the hash functions only depend on the repetition and configuration, not on the thread running it
+    gen.seed(seed * bin_capacities.size() + experiment);
+    const std::vector<uint32_t> input_sequence = DistinctKeys<uint32_t>(seed).generate(0, num_insertions);
+    Trace trace(num_metrics * insert_loop_iterations.size() * num_insertions);
+    for (std::size_t setting = 0; setting < insert_loop_iterations.size(); ++setting)
     {
-        std::cerr << "Failed to open the file.\n";
-        return 1;
+        const int iterations = insert_loop_iterations[setting];
+        std::unique_ptr<Backyard> backyard = std::make_unique<Backyard>(
+            iterations ? iterations : adaptive_min_iterations, iterations ? iterations : adaptive_max_iterations,
+            adaptive_queue_low_watermark, adaptive_queue_high_watermark);
+        for (int j = 0; j < num_insertions; ++j)
+        {
+            backyard->insert(input_sequence[j]);
+            const int bins_queue_size = backyard->bins.size() + backyard->queue.size();
+            trace[trace_index(bins_size, setting, j)] = backyard->bins.size();
+            trace[trace_index(queue_size, setting, j)] = backyard->queue.size();
+            trace[trace_index(cdm_size, setting, j)] = backyard->cdm.size();
+            trace[trace_index(cuckoo_tables_size, setting, j)] = backyard->size() - bins_queue_size;
+        }
     }
-    // Write the CSV header
-    csv_file << "bin_capacity,max_size_cuckoo_tables,insert_loop_iterations,num_repetition,time_step,bins_size,queue_size,cdm_size,cuckoo_tables_size\n";
+    return trace;
+}
 
-    std::vector<int> insert_loop_iterations{2, 4, 8, 12, 16, 20};
-    std::srand(42);
+template <std::size_t... experiments>
+constexpr std::array<Trace (*)(int), sizeof...(experiments)> repetition_runners(std::index_sequence<experiments...>)
+{
+    return {&run_repetition<experiments>...};
+}
 
-    for (int i = 0; i < num_repetitions; ++i)
+int main(int argc, char **argv)
+{
+    const int num_repetitions = argc > 1 ? std::stoi(argv[1]) : 100;
+    std::vector<int> experiments;
+    for (int i = 2; i < argc; ++i)
     {
-        std::vector<uint32_t> input_sequence = create_random_input_sequence(num_insertions, std::rand());
-        for (int iterations : insert_loop_iterations)
+        const auto position = std::find(bin_capacities.begin(), bin_capacities.end(), std::stoi(argv[i]));
+        if (position == bin_capacities.end())
         {
-            BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm>
-                backyard(iterations);
-            for (int j = 0; j < input_sequence.size(); ++j)
-            {
-                backyard.insert(input_sequence[j]);
-                int backyard_size = backyard.size();
-                int bins_queue_size = backyard.bins.size() + backyard.queue.size();
-                csv_file << bin_capacity << "," << size_cuckoo_tables << "," << iterations << "," << i << ","
-                         << j << "," << backyard.bins.size() << "," << backyard.queue.size() << ","
-                         << backyard.cdm.size() << "," << backyard_size - bins_queue_size << "\n";
-            }
+            std::cerr << "no configuration with bin capacity " << argv[i] << "\n";
+            return 1;
         }
+        experiments.push_back(position - bin_capacities.begin());
+    }
+    if (experiments.empty())
+    {
+        for (std::size_t experiment = 0; experiment < bin_capacities.size(); ++experiment)
+        {
+            experiments.push_back(experiment);
+        }
+    }
+    std::filesystem::create_directories("data");
+
+    // one seed per repetition for the input sequence (DistinctKeys) and the hash functions
+    std::srand(42);
+    std::vector<int> seeds;
+    for (int i = 0; i < num_repetitions; ++i)
+    {
+        seeds.push_back(std::rand());
     }
 
-    // // Write the data to the CSV file
-    // Close the file
-    csv_file.close();
+    constexpr auto runners = repetition_runners(std::make_index_sequence<bin_capacities.size()>());
+    std::vector<Aggregate> aggregates(bin_capacities.size());
+    // tasks are ordered by repetition, so all configurations make progress at the same time
+    const int num_tasks = num_repetitions * experiments.size();
+    std::atomic<int> next_task = 0;
+    const int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int task = next_task++; task < num_tasks; task = next_task++)
+            {
+                const int experiment = experiments[task % experiments.size()];
+                aggregates[experiment].add(runners[experiment](seeds[task / experiments.size()]));
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int experiment : experiments)
+    {
+        const std::string file_name = "data/data_bin_cap_" + std::to_string(bin_capacities[experiment]) + ".bin";
+        aggregates[experiment].write(file_name, bin_capacities[experiment], sizes_cuckoo_tables[experiment]);
+    }
+    std::cout << num_tasks << " repetitions on " << num_threads << " threads in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
 
     return 1;
-}
\ No newline at end of file
+}
@@ -1,20 +1,16 @@
-import pandas as pd
 import matplotlib.pyplot as plt
+from aggregate import read_aggregate
 
 def plot_cdm_size(bin_capacity):
     folder = "experiments/auxiliary_structures_size/"
 
-    # Read the CSV file
-    file_path = folder + "data/data_bin_cap_{}.csv".format(bin_capacity)
-    data = pd.read_csv(file_path)
-
-    # Group by 'insert_loop_iterations' and 'time_step', calculate the mean and std of 'cdm_size'
-    grouped_data = data.groupby(['insert_loop_iterations', 'time_step'])['cdm_size'].agg(['max', 'mean', 'std']).reset_index()
+    # Read the statistics over the repetitions
+    data = read_aggregate(bin_capacity)
 
     # Create a pivot table for mean and std
-    max_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='max')
-    mean_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='mean')
-    std_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='std')
+    max_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='cdm_size_max')
+    mean_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='cdm_size_mean')
+    std_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='cdm_size_std')
 
     # Plot the data
     plt.figure(figsize=(12, 8))
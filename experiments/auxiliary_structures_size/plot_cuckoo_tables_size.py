@@ -1,5 +1,5 @@
-import pandas as pd
 import matplotlib.pyplot as plt
+from aggregate import read_aggregate
 
 bin_capacities = [1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64]
 cuckoo_table_sizes = [2453, 1804, 1303, 1071, 930, 762, 661, 542, 702, 384, 333]
@@ -9,16 +9,12 @@ def plot_cuckoo_tables_size(bin_capacity):
     experiment_index = bin_capacities.index(bin_capacity)
     cuckoo_table_size = cuckoo_table_sizes[experiment_index] * 2
 
-    # Read the CSV file
-    file_path = folder + "data/data_bin_cap_{}.csv".format(bin_capacity)
-    data = pd.read_csv(file_path)
-
-    # Group by 'insert_loop_iterations' and 'time_step', calculate the mean and std of 'queue_size'
-    grouped_data = data.groupby(['insert_loop_iterations', 'time_step'])['cuckoo_tables_size'].agg(['mean', 'std']).reset_index()
+    # Read the statistics over the repetitions
+    data = read_aggregate(bin_capacity)
 
     # Create a pivot table for mean and std
-    mean_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='mean')
-    # std_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='std')
+    mean_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='cuckoo_tables_size_mean')
+    # std_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='cuckoo_tables_size_std')
 
     # Plot the data
     plt.figure(figsize=(12, 8))
@@ -1,16 +1,13 @@
-import pandas as pd
 import matplotlib.pyplot as plt
+from aggregate import read_aggregate
 
 def plot_max_queue_size(bin_capacity):
     folder = "experiments/auxiliary_structures_size/"
 
-    # Read the CSV file
-    file_path = folder + "data/data_bin_cap_{}.csv".format(bin_capacity)
-    data = pd.read_csv(file_path)
+    # Read the statistics over the repetitions
+    data = read_aggregate(bin_capacity)
 
-    grouped_data = data.groupby(['insert_loop_iterations', 'time_step'])['queue_size'].agg(['max']).reset_index()
-
-    max_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='max')
+    max_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='queue_size_max')
 
     # Plot the data
     plt.figure(figsize=(12, 8))
@@ -34,16 +31,12 @@ def plot_max_queue_size(bin_capacity):
 def plot_mean_queue_size(bin_capacity):
     folder = "experiments/auxiliary_structures_size/"
 
-    # Read the CSV file
-    file_path = folder + "data/data_bin_cap_{}.csv".format(bin_capacity)
-    data = pd.read_csv(file_path)
-
-    # Group by 'insert_loop_iterations' and 'time_step', calculate the mean and std of 'queue_size'
-    grouped_data = data.groupby(['insert_loop_iterations', 'time_step'])['queue_size'].agg(['mean']).reset_index() # 'std'
+    # Read the statistics over the repetitions
+    data = read_aggregate(bin_capacity)
 
     # Create a pivot table for mean and std
-    mean_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='mean')
-    # std_pivot = grouped_data.pivot(index='time_step', columns='insert_loop_iterations', values='std')
+    mean_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='queue_size_mean')
+    # std_pivot = data.pivot(index='time_step', columns='insert_loop_iterations', values='queue_size_std')
 
     # Plot the data
     plt.figure(figsize=(12, 8))
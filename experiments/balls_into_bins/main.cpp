@@ -5,8 +5,8 @@
 #include <numeric>
 #include <utility>
 #include <fstream>
-#include <unordered_set>
 #include "../../src/hash.h"
+#include "../../src/workload.h"
 
 std::pair<double, double> calculate_average_and_stddev(const std::vector<int> &elements)
 {
@@ -31,25 +31,6 @@ std::pair<double, double> calculate_average_and_stddev(const std::vector<int> &e
     return {average, stddev};
 }
 
-std::vector<uint32_t> create_random_input_sequence(int num_elements, int seed)
-{
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<uint32_t> dis(0, UINT32_MAX);
-    std::unordered_set<uint32_t> elems;
-
-    for (int i = 0; i < num_elements; ++i)
-    {
-        uint32_t value = dis(gen);
-        while (elems.find(value) != elems.end())
-        {
-            value = dis(gen);
-        }
-        elems.insert(value);
-    }
-
-    return std::vector<uint32_t>(elems.begin(), elems.end());
-}
-
 std::vector<uint32_t> create_range_sequence(int num_elements)
 {
     std::vector<uint32_t> elems(num_elements);
@@ -95,6 +76,35 @@ int calculate_number_of_overflowing_elements_balls_into_bins(int num_bins, int b
     return num_overflowing_elements;
 }
 
+// power of two choices: every element goes to the less loaded of its two candidate bins
+int calculate_number_of_overflowing_elements_two_choices(int num_bins, int bin_capacity, std::vector<uint32_t> input_sequence)
+{
+    TornadoHash<uint32_t> h1 = TornadoHash<uint32_t>();
+    TornadoHash<uint32_t> h2 = TornadoHash<uint32_t>();
+    h1.set_range(num_bins);
+    h2.set_range(num_bins);
+    std::vector<int> bins(num_bins, bin_capacity);
+
+    int num_overflowing_elements = 0;
+    for (uint32_t value : input_sequence)
+    {
+        uint32_t hash_value1 = h1.hash(value);
+        uint32_t hash_value2 = h2.hash(value);
+        // bins store the remaining space, so the less loaded bin has more space left
+        uint32_t hash_value = bins[hash_value2] > bins[hash_value1] ? hash_value2 : hash_value1;
+        if (bins[hash_value])
+        {
+            bins[hash_value]--;
+        }
+        else
+        {
+            num_overflowing_elements++;
+        }
+    }
+
+    return num_overflowing_elements;
+}
+
 int main()
 {
     // Open the output CSV file
@@ -105,7 +115,7 @@ int main()
         return 1;
     }
     // Write the CSV header
-    csv_file << "load_factor,bin_capacity,num_bins,average,stddev\n";
+    csv_file << "num_choices,load_factor,bin_capacity,num_bins,average,stddev\n";
 
     int num_repetitions = 100;
     int num_elements = 100000;
@@ -113,27 +123,33 @@ int main()
     std::vector<int> bin_capacities{1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
     std::vector<double> load_factors{1.0, 0.95, 0.9, 0.8};
 
-    std::vector<uint32_t> input_sequence = create_random_input_sequence(num_elements, 42);
+    std::vector<uint32_t> input_sequence = DistinctKeys<uint32_t>(42).generate(0, num_elements);
 
-    for (double load_factor : load_factors)
+    for (int num_choices : {1, 2})
     {
-        for (int bin_capacity : bin_capacities)
+        for (double load_factor : load_factors)
         {
-            std::vector<int> results(num_repetitions, 0);
-            int num_bins = num_elements / (bin_capacity * load_factor);
-
-            for (int i = 0; i < num_repetitions; i++)
+            for (int bin_capacity : bin_capacities)
             {
-                results[i] = calculate_number_of_overflowing_elements_balls_into_bins(
-                    num_bins, bin_capacity, input_sequence);
+                std::vector<int> results(num_repetitions, 0);
+                int num_bins = num_elements / (bin_capacity * load_factor);
+
+                for (int i = 0; i < num_repetitions; i++)
+                {
+                    results[i] = num_choices == 1
+                                     ? calculate_number_of_overflowing_elements_balls_into_bins(
+                                           num_bins, bin_capacity, input_sequence)
+                                     : calculate_number_of_overflowing_elements_two_choices(
+                                           num_bins, bin_capacity, input_sequence);
+                }
+                std::pair<double, double> result = calculate_average_and_stddev(results);
+                double average_number_of_overflowing_elemtents = result.first;
+                double stddev_number_of_overflowing_elements = result.second;
+
+                // Write the data to the CSV file
+                csv_file << num_choices << "," << load_factor << "," << bin_capacity << "," << num_bins << ","
+                         << average_number_of_overflowing_elemtents << "," << stddev_number_of_overflowing_elements << "\n";
             }
-            std::pair<double, double> result = calculate_average_and_stddev(results);
-            double average_number_of_overflowing_elemtents = result.first;
-            double stddev_number_of_overflowing_elements = result.second;
-
-            // Write the data to the CSV file
-            csv_file << load_factor << "," << bin_capacity << "," << num_bins << ","
-                     << average_number_of_overflowing_elemtents << "," << stddev_number_of_overflowing_elements << "\n";
         }
     }
     // Close the file
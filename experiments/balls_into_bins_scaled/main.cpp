@@ -0,0 +1,407 @@
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../../src/hash.h"
+#include "../../src/workload.h"
+
+// Balls into bins at production sizes: counts the elements that don't fit into their bin for up to 2^32 keys,
+// for several hash families and key sequences, and compares the average with the expectation for truly random
+// bins (Poisson loads). Keys are computed from a counter instead of being stored, every bin load is one byte.
+// Repetitions run in parallel on all cores as long as their bins fit into the memory budget (half of the
+// physical memory), keys are hashed in batches by loops the compiler can vectorize (compile with
+// -O3 -march=native, e.g. multiply-shift and murmur become SIMD code, tornado uses gathers with AVX2).
+// usage: main [num_keys] [num_repetitions] [bin capacities...]   (default: 10^8 keys, 10 repetitions)
+
+constexpr int batch_size = 1024;
+
+// The families map a batch of keys to bins in [0, num_bins). Each is set up from the global generator.
+class TornadoFamily
+{
+public:
+    explicit TornadoFamily(uint32_t num_bins)
+    {
+        h.set_range(num_bins);
+    }
+
+    void hash_batch(const uint32_t *keys, uint32_t *bins, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            bins[i] = h.hash(keys[i]);
+        }
+    }
+
+private:
+    TornadoHash<uint32_t> h;
+};
+
+class CarterWegmanFamily
+{
+public:
+    explicit CarterWegmanFamily(uint32_t num_bins)
+    {
+        h.set_range(num_bins);
+    }
+
+    void hash_batch(const uint32_t *keys, uint32_t *bins, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            bins[i] = h.hash(keys[i]);
+        }
+    }
+
+private:
+    CarterWegmanHash<uint32_t> h;
+};
+
+// upper 32 bits of a * x + b with random 64 bit a and b (Dietzfelbinger), reduced to the bins by a
+// multiplication instead of a modulo
+class MultiplyShiftFamily
+{
+public:
+    explicit MultiplyShiftFamily(uint32_t num_bins) : num_bins(num_bins)
+    {
+        std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
+        a = dist(gen);
+        b = dist(gen);
+    }
+
+    void hash_batch(const uint32_t *keys, uint32_t *bins, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const uint64_t h = (a * keys[i] + b) >> 32;
+            bins[i] = (h * num_bins) >> 32;
+        }
+    }
+
+private:
+    uint64_t a, b, num_bins;
+};
+
+// simple tabulation: one table of random words per byte of the key
+class SimpleTabulationFamily
+{
+public:
+    explicit SimpleTabulationFamily(uint32_t num_bins) : num_bins(num_bins)
+    {
+        std::uniform_int_distribution<uint32_t> dist(0, UINT32_MAX);
+        for (std::array<uint32_t, 256> &table : tables)
+        {
+            for (uint32_t &entry : table)
+            {
+                entry = dist(gen);
+            }
+        }
+    }
+
+    void hash_batch(const uint32_t *keys, uint32_t *bins, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const uint32_t x = keys[i];
+            const uint64_t h = tables[0][x & 255] ^ tables[1][(x >> 8) & 255] ^ tables[2][(x >> 16) & 255] ^
+                               tables[3][x >> 24];
+            bins[i] = (h * num_bins) >> 32;
+        }
+    }
+
+private:
+    std::array<std::array<uint32_t, 256>, 4> tables;
+    uint64_t num_bins;
+};
+
+// finalizer of murmur3 applied to the key xor a random seed (no guarantees, but common in practice)
+class MurmurFamily
+{
+public:
+    explicit MurmurFamily(uint32_t num_bins) : num_bins(num_bins)
+    {
+        std::uniform_int_distribution<uint32_t> dist(0, UINT32_MAX);
+        seed = dist(gen);
+    }
+
+    void hash_batch(const uint32_t *keys, uint32_t *bins, int n) const
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            uint32_t h = keys[i] ^ seed;
+            h ^= h >> 16;
+            h *= 0x85ebca6b;
+            h ^= h >> 13;
+            h *= 0xc2b2ae35;
+            h ^= h >> 16;
+            bins[i] = (uint64_t(h) * num_bins) >> 32;
+        }
+    }
+
+private:
+    uint32_t seed;
+    uint64_t num_bins;
+};
+
+const std::vector<std::string> families{"tornado", "carter_wegman", "multiply_shift", "simple_tabulation", "murmur"};
+const std::vector<std::string> inputs{"random", "range", "stride", "stride_pow2"};
+
+// Distinct keys computed from a counter: a random permutation of it, the counter itself, multiples of an odd
+// number (distinct modulo 2^32) and multiples of the largest power of two for which they don't wrap around
+// (at most 2^31, a single key would allow a shift by 32)
+class KeySequence
+{
+public:
+    KeySequence(const std::string &input, uint64_t num_keys, uint64_t seed)
+        : kind(std::find(inputs.begin(), inputs.end(), input) - inputs.begin()),
+          stride(kind == 2 ? 7 : uint32_t(1) << std::clamp(32 - (int)std::bit_width(num_keys - 1), 0, 31)),
+          random_keys(seed)
+    {
+    }
+
+    void fill(uint64_t first, uint32_t *keys, int n) const
+    {
+        if (kind == 0)
+        {
+            random_keys.fill(first, keys, n);
+            return;
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            keys[i] = uint32_t(first + i) * (kind == 1 ? 1 : stride);
+        }
+    }
+
+private:
+    std::size_t kind;
+    uint32_t stride;
+    DistinctKeys<uint32_t> random_keys;
+};
+
+template <typename Family>
+uint64_t count_overflow(const KeySequence &keys, uint64_t num_keys, uint32_t num_bins, int bin_capacity)
+{
+    const Family h(num_bins);
+    // loads saturate at 255, only possible for a broken hash function and still far above every bin capacity
+    std::vector<uint8_t> loads(num_bins, 0);
+    std::array<uint32_t, batch_size> batch_keys, batch_bins;
+    for (uint64_t first = 0; first < num_keys; first += batch_size)
+    {
+        const int n = std::min<uint64_t>(batch_size, num_keys - first);
+        keys.fill(first, batch_keys.data(), n);
+        h.hash_batch(batch_keys.data(), batch_bins.data(), n);
+        for (int i = 0; i < n; ++i)
+        {
+            uint8_t &load = loads[batch_bins[i]];
+            load += load != 255;
+        }
+    }
+    uint64_t overflow = 0;
+    for (uint8_t load : loads)
+    {
+        overflow += std::max(int(load) - bin_capacity, 0);
+    }
+    return overflow;
+}
+
+uint64_t count_overflow(const std::string &family, const KeySequence &keys, uint64_t num_keys, uint32_t num_bins,
+                        int bin_capacity)
+{
+    if (family == "tornado")
+    {
+        return count_overflow<TornadoFamily>(keys, num_keys, num_bins, bin_capacity);
+    }
+    if (family == "carter_wegman")
+    {
+        return count_overflow<CarterWegmanFamily>(keys, num_keys, num_bins, bin_capacity);
+    }
+    if (family == "multiply_shift")
+    {
+        return count_overflow<MultiplyShiftFamily>(keys, num_keys, num_bins, bin_capacity);
+    }
+    if (family == "simple_tabulation")
+    {
+        return count_overflow<SimpleTabulationFamily>(keys, num_keys, num_bins, bin_capacity);
+    }
+    return count_overflow<MurmurFamily>(keys, num_keys, num_bins, bin_capacity);
+}
+
+// expected overflow if every bin is Poisson(num_keys / num_bins) distributed
+double expected_random_overflow(uint64_t num_keys, uint32_t num_bins, int bin_capacity)
+{
+    const double lambda = double(num_keys) / num_bins;
+    double probability = std::exp(-lambda);
+    double expected = 0;
+    for (int load = 1; load <= bin_capacity + 10 * lambda + 100; ++load)
+    {
+        probability *= lambda / load;
+        expected += probability * std::max(load - bin_capacity, 0);
+    }
+    return expected * num_bins;
+}
+
+// lets tasks start only while the bins of all running tasks fit into the budget (a single task always runs)
+class MemoryBudget
+{
+public:
+    explicit MemoryBudget(uint64_t bytes) : available(bytes), budget(bytes)
+    {
+    }
+
+    void acquire(uint64_t bytes)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [&]()
+                      { return bytes <= available || available == budget; });
+        available -= std::min(bytes, available);
+        in_use.push_back(bytes);
+    }
+
+    void release(uint64_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        in_use.erase(std::find(in_use.begin(), in_use.end(), bytes));
+        available = budget - std::min(budget, std::accumulate(in_use.begin(), in_use.end(), uint64_t(0)));
+        released.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable released;
+    std::vector<uint64_t> in_use;
+    uint64_t available;
+    uint64_t budget;
+};
+
+struct Configuration
+{
+    std::string family;
+    std::string input;
+    double load_factor;
+    int bin_capacity;
+    uint32_t num_bins;
+};
+
+int main(int argc, char **argv)
+{
+    const uint64_t num_keys = argc > 1 ? std::stoull(argv[1]) : 100000000;
+    const int num_repetitions = argc > 2 ? std::stoi(argv[2]) : 10;
+    std::vector<int> bin_capacities{1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+    if (argc > 3)
+    {
+        bin_capacities.clear();
+        for (int i = 3; i < argc; ++i)
+        {
+            bin_capacities.push_back(std::stoi(argv[i]));
+        }
+    }
+    if (num_keys < 1 || num_keys > (uint64_t(1) << 32))
+    {
+        std::cerr << "the number of keys has to be in [1, 2^32]\n";
+        return 1;
+    }
+    const std::vector<double> load_factors{1.0, 0.95, 0.9, 0.8};
+
+    // Open the output CSV file
+    std::ofstream csv_file("data.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "family,keys,num_keys,load_factor,bin_capacity,num_bins,repetitions,average,stddev,min,max,"
+                "expected_random\n";
+
+    std::vector<Configuration> configurations;
+    for (const std::string &family : families)
+    {
+        for (const std::string &input : inputs)
+        {
+            for (double load_factor : load_factors)
+            {
+                for (int bin_capacity : bin_capacities)
+                {
+                    const double num_bins = std::ceil(num_keys / (bin_capacity * load_factor));
+                    if (num_bins <= UINT32_MAX)
+                    {
+                        configurations.push_back({family, input, load_factor, bin_capacity, uint32_t(num_bins)});
+                    }
+                }
+            }
+        }
+    }
+
+    // every (configuration, repetition) is a task, the results are collected per configuration
+    std::vector<std::vector<uint64_t>> results(configurations.size(), std::vector<uint64_t>(num_repetitions));
+    const uint64_t num_tasks = configurations.size() * num_repetitions;
+    std::atomic<uint64_t> next_task = 0;
+    MemoryBudget budget(uint64_t(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGE_SIZE) / 2);
+    const int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (uint64_t task = next_task++; task < num_tasks; task = next_task++)
+            {
+                const std::size_t c = task / num_repetitions;
+                const int repetition = task % num_repetitions;
+                const Configuration &configuration = configurations[c];
+                // hash functions and the random keys only depend on the task, not on the thread running it
+                gen.seed(task);
+                const KeySequence keys(configuration.input, num_keys, task);
+                budget.acquire(configuration.num_bins);
+                results[c][repetition] = count_overflow(configuration.family, keys, num_keys, configuration.num_bins,
+                                                        configuration.bin_capacity);
+                budget.release(configuration.num_bins);
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t c = 0; c < configurations.size(); ++c)
+    {
+        const Configuration &configuration = configurations[c];
+        const std::vector<uint64_t> &overflows = results[c];
+        const double average = std::accumulate(overflows.begin(), overflows.end(), 0.0) / num_repetitions;
+        double variance = 0;
+        for (uint64_t overflow : overflows)
+        {
+            variance += (overflow - average) * (overflow - average);
+        }
+        variance /= num_repetitions;
+
+        // Write the data to the CSV file
+        csv_file << configuration.family << "," << configuration.input << "," << num_keys << ","
+                 << configuration.load_factor << "," << configuration.bin_capacity << "," << configuration.num_bins
+                 << "," << num_repetitions << "," << average << "," << std::sqrt(variance) << ","
+                 << *std::min_element(overflows.begin(), overflows.end()) << ","
+                 << *std::max_element(overflows.begin(), overflows.end()) << ","
+                 << expected_random_overflow(num_keys, configuration.num_bins, configuration.bin_capacity) << "\n";
+    }
+    std::cout << num_tasks << " repetitions of " << num_keys << " keys on " << num_threads << " threads in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s\n";
+
+    // Close the file
+    csv_file.close();
+
+    return 1;
+}
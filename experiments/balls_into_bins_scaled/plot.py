@@ -0,0 +1,34 @@
+import os
+import pandas as pd
+import matplotlib.pyplot as plt
+
+folder = "experiments/balls_into_bins_scaled/"
+os.makedirs(folder + "plots", exist_ok=True)
+
+# Load the data
+data = pd.read_csv(folder + "data.csv")
+
+# one plot per load factor: percentage of overflowing elements per bin capacity, one subplot per key sequence,
+# the dashed line is the expectation for truly random bins
+for load_factor, by_load in data.groupby("load_factor"):
+    inputs = list(by_load["keys"].unique())
+    fig, axes = plt.subplots(1, len(inputs), figsize=(5 * len(inputs), 5), sharey=True, squeeze=False)
+    for ax, keys in zip(axes[0], inputs):
+        group = by_load[by_load["keys"] == keys]
+        for family, by_family in group.groupby("family"):
+            by_family = by_family.sort_values("bin_capacity")
+            percentage = 100 / by_family["num_keys"]
+            ax.errorbar(by_family["bin_capacity"].astype(str), by_family["average"] * percentage,
+                        yerr=by_family["stddev"] * percentage, fmt='-o', capsize=3, markersize=3, label=family)
+        expected = group.drop_duplicates("bin_capacity").sort_values("bin_capacity")
+        ax.plot(expected["bin_capacity"].astype(str), expected["expected_random"] * 100 / expected["num_keys"],
+                linestyle='--', color='black', label="random bins")
+        ax.set_title(f"{keys} keys")
+        ax.set_xlabel("Bin Capacity", fontsize=12)
+        ax.grid(linestyle='--', alpha=0.7)
+    axes[0][0].set_ylabel("Percentage of Overflowing Elements", fontsize=12)
+    axes[0][-1].legend(title="Hash Family")
+    fig.suptitle(f"{data['num_keys'].iloc[0]} keys, load factor {load_factor}")
+    fig.tight_layout()
+    fig.savefig(folder + f"plots/load_factor_{load_factor}.png", dpi=300)
+    plt.close(fig)
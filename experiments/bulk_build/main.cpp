@@ -0,0 +1,90 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "../../src/backyard.h"
+
+constexpr int num_bins = 1 << 21;
+constexpr int bin_capacity = 8;
+constexpr int size_cuckoo_tables = 1 << 20;
+constexpr int n_queue = 1000;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 1000;
+constexpr int n_cdm = 1000;
+constexpr int k_cdm = 20;
+constexpr int num_insert_loop_iterations = 16;
+
+using Set = BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                  num_elems_cdm, n_cdm, k_cdm>;
+
+// random keys, duplicates are possible (build_from ignores them like insert does)
+std::vector<uint32_t> create_random_keys(int num_elements, int seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> dis(0, UINT32_MAX);
+    std::vector<uint32_t> keys(num_elements);
+    for (uint32_t &key : keys)
+    {
+        key = dis(gen);
+    }
+    return keys;
+}
+
+// num_threads = 0 inserts the keys one by one
+double measure_build_seconds(const std::vector<uint32_t> &keys, int num_threads)
+{
+    std::unique_ptr<Set> set = std::make_unique<Set>(num_insert_loop_iterations);
+    const auto start = std::chrono::steady_clock::now();
+    if (num_threads == 0)
+    {
+        for (uint32_t key : keys)
+        {
+            set->insert(key);
+        }
+    }
+    else
+    {
+        set->build_from(keys, num_threads);
+    }
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    return seconds.count();
+}
+
+int main()
+{
+    // Open the output CSV file
+    std::ofstream csv_file("data.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "load_factor,num_threads,seconds\n";
+
+    std::vector<int> thread_counts{0, 1, 2, 4, 8, 16, 32, 64};
+    std::vector<double> load_factors{0.5, 0.75};
+    for (double load_factor : load_factors)
+    {
+        const std::vector<uint32_t> keys = create_random_keys(load_factor * num_bins * bin_capacity, 0);
+        for (int num_threads : thread_counts)
+        {
+            if (num_threads > (int)std::thread::hardware_concurrency())
+            {
+                continue;
+            }
+            const double seconds = measure_build_seconds(keys, num_threads);
+            csv_file << load_factor << "," << num_threads << "," << seconds << "\n";
+            std::cout << "load_factor=" << load_factor << " threads=" << num_threads << " " << seconds << "s\n";
+        }
+    }
+
+    // Close the file
+    csv_file.close();
+
+    return 1;
+}
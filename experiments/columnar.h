@@ -0,0 +1,83 @@
+#ifndef columnar_
+#define columnar_
+
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../src/serialization.h"
+
+// Table of equally long columns written column by column, so a reader loads a column with a single read
+// (experiments/columnar.py reads it into a pandas DataFrame). Layout, little endian:
+//   magic "BYCO", version, number of rows (uint64), number of columns (uint32),
+//   per column: length of the name (uint32), name, type (uint8, 0 = int32, 1 = float64), the values
+class ColumnarTable
+{
+public:
+    void add_column(const std::string &name, std::vector<int32_t> values)
+    {
+        check_length(values.size());
+        columns.push_back({name, std::move(values)});
+    }
+
+    void add_column(const std::string &name, std::vector<double> values)
+    {
+        check_length(values.size());
+        columns.push_back({name, std::move(values)});
+    }
+
+    void write(const std::string &path) const
+    {
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+        {
+            throw std::runtime_error("Columnar Table: can't open " + path);
+        }
+        write_raw(out, magic);
+        write_raw(out, version);
+        write_raw(out, (uint64_t)num_rows);
+        write_raw(out, (uint32_t)columns.size());
+        for (const Column &column : columns)
+        {
+            write_raw(out, (uint32_t)column.name.size());
+            out.write(column.name.data(), column.name.size());
+            write_raw(out, (uint8_t)column.values.index());
+            std::visit([&out](const auto &values)
+                       { out.write(reinterpret_cast<const char *>(values.data()),
+                                   values.size() * sizeof(values[0])); },
+                       column.values);
+        }
+        if (!out.flush())
+        {
+            throw std::runtime_error("Columnar Table: writing " + path + " failed");
+        }
+    }
+
+private:
+    struct Column
+    {
+        std::string name;
+        std::variant<std::vector<int32_t>, std::vector<double>> values;
+    };
+
+    // "BYCO" in little endian
+    static constexpr uint32_t magic = 0x4f435942;
+    static constexpr uint32_t version = 1;
+
+    std::vector<Column> columns;
+    std::size_t num_rows = 0;
+
+    void check_length(std::size_t length)
+    {
+        if (!columns.empty() && length != num_rows)
+        {
+            throw std::invalid_argument("Columnar Table: all columns need the same number of rows");
+        }
+        num_rows = length;
+    }
+};
+
+#endif
@@ -0,0 +1,28 @@
+import struct
+import numpy as np
+import pandas as pd
+
+# Reader for the tables written by ColumnarTable (experiments/columnar.h)
+MAGIC = 0x4f435942
+VERSION = 1
+TYPES = {0: np.int32, 1: np.float64}
+
+
+def read_columns(file_path):
+    with open(file_path, "rb") as file:
+        data = file.read()
+    magic, version, num_rows, num_columns = struct.unpack_from("<IIQI", data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(file_path + " is no columnar table of this version")
+    offset = struct.calcsize("<IIQI")
+    columns = {}
+    for _ in range(num_columns):
+        (name_length,) = struct.unpack_from("<I", data, offset)
+        offset += 4
+        name = data[offset:offset + name_length].decode()
+        offset += name_length
+        dtype = TYPES[data[offset]]
+        offset += 1
+        columns[name] = np.frombuffer(data, dtype=dtype, count=num_rows, offset=offset)
+        offset += num_rows * np.dtype(dtype).itemsize
+    return pd.DataFrame(columns)
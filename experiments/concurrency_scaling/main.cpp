@@ -0,0 +1,259 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include "../../src/backyard.h"
+#include "../../src/concurrent_backyard.h"
+#include "../../src/optimistic_backyard.h"
+#include "../../src/sharded_backyard.h"
+
+constexpr int num_bins = 1 << 16;
+constexpr int bin_capacity = 8;
+constexpr int size_cuckoo_tables = 1 << 14;
+constexpr int n_queue = 1000;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 1000;
+constexpr int n_cdm = 1000;
+constexpr int k_cdm = 20;
+constexpr int num_insert_loop_iterations = 8;
+
+// baseline: one instance protected by a single global mutex
+class MutexBackyard
+{
+public:
+    MutexBackyard(int insert_loop_iterations) : backyard(insert_loop_iterations)
+    {
+    }
+
+    void insert(uint32_t item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        backyard.insert(item);
+    }
+
+    bool remove(uint32_t item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return backyard.remove(item);
+    }
+
+    bool contains(uint32_t item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return backyard.contains(item);
+    }
+
+private:
+    std::mutex mutex;
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm>
+        backyard;
+};
+
+using StripedBackyard = ConcurrentBackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue,
+                                                        k_queue, num_elems_cdm, n_cdm, k_cdm, 1024>;
+using OptimisticBackyard = OptimisticBackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue,
+                                                           k_queue, num_elems_cdm, n_cdm, k_cdm>;
+// same total capacity split into shards
+constexpr int num_shards = 8;
+using Shard = BackyardCuckooHashing<uint32_t, num_bins / num_shards, bin_capacity, size_cuckoo_tables / num_shards, n_queue,
+                                    k_queue, num_elems_cdm, n_cdm, k_cdm>;
+using ShardedSet = ShardedBackyard<uint32_t, num_shards, Shard>;
+
+// threads collect their operations into batches of this size
+constexpr int batch_size = 64;
+
+template <typename Set>
+void apply(Set &set, std::vector<Operation<uint32_t>> &batch)
+{
+    for (Operation<uint32_t> &operation : batch)
+    {
+        switch (operation.type)
+        {
+        case OperationType::insert:
+            set.insert(operation.key);
+            break;
+        case OperationType::remove:
+            operation.result = set.remove(operation.key);
+            break;
+        case OperationType::contains:
+            operation.result = set.contains(operation.key);
+            break;
+        }
+    }
+}
+
+// the sharded set gets the whole batch at once
+template <>
+void apply(ShardedSet &set, std::vector<Operation<uint32_t>> &batch)
+{
+    set.execute(batch);
+}
+
+// every thread works on its own key range: lookups of random keys of the range, and writes that alternate
+// between inserting and removing keys, so the load factor stays the same during the run
+template <typename Set>
+double run_mixed_workload(Set &set, int num_threads, double read_ratio, int operations_per_thread, int keys_per_thread)
+{
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&set, t, read_ratio, operations_per_thread, keys_per_thread]()
+                             {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<uint32_t> key(0, keys_per_thread - 1);
+            std::uniform_real_distribution<double> operation(0.0, 1.0);
+            const uint32_t offset = t * keys_per_thread;
+            bool insert = true;
+            std::vector<Operation<uint32_t>> batch;
+            for (int i = 0; i < operations_per_thread; ++i)
+            {
+                const uint32_t value = offset + key(gen);
+                if (operation(gen) < read_ratio)
+                {
+                    batch.push_back({OperationType::contains, value, false});
+                }
+                else
+                {
+                    batch.push_back({insert ? OperationType::insert : OperationType::remove, value, false});
+                    insert = !insert;
+                }
+                if ((int)batch.size() == batch_size)
+                {
+                    apply(set, batch);
+                    batch.clear();
+                }
+            }
+            apply(set, batch); });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    return num_threads * operations_per_thread / seconds.count() / 1e6;
+}
+
+// num_readers threads only look up keys while one writer thread keeps inserting and removing keys,
+// returns the lookup throughput
+template <typename Set>
+double run_readers_with_writer(Set &set, int num_readers, int lookups_per_reader, int num_keys)
+{
+    std::atomic<bool> done = false;
+    std::thread writer([&set, &done, num_keys]()
+                       {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<uint32_t> key(0, num_keys - 1);
+        while (!done.load(std::memory_order_relaxed))
+        {
+            const uint32_t value = key(gen);
+            set.remove(value);
+            set.insert(value);
+        } });
+
+    std::vector<std::thread> readers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < num_readers; ++t)
+    {
+        readers.emplace_back([&set, t, lookups_per_reader, num_keys]()
+                             {
+            std::mt19937 gen(t + 1);
+            std::uniform_int_distribution<uint32_t> key(0, 2 * num_keys - 1);
+            for (int i = 0; i < lookups_per_reader; ++i)
+            {
+                set.contains(key(gen));
+            } });
+    }
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    done.store(true);
+    writer.join();
+    return num_readers * lookups_per_reader / seconds.count() / 1e6;
+}
+
+template <typename Set>
+void run_read_experiment(std::ofstream &csv_file, const std::string &name, int num_readers)
+{
+    constexpr int lookups_per_reader = 1000000;
+    const int num_keys = num_bins * bin_capacity / 2;
+    std::unique_ptr<Set> set = std::make_unique<Set>(num_insert_loop_iterations);
+    for (int i = 0; i < num_keys; ++i)
+    {
+        set->insert(i);
+    }
+    const double mops = run_readers_with_writer(*set, num_readers, lookups_per_reader, num_keys);
+    csv_file << name << "," << num_readers << "," << mops << "\n";
+    std::cout << name << " readers=" << num_readers << " + 1 writer " << mops << " Mops/s\n";
+}
+
+template <typename Set>
+void run_experiment(std::ofstream &csv_file, const std::string &name, int num_threads, double read_ratio)
+{
+    constexpr int operations_per_thread = 200000;
+    // prefill the set with every other key, half of all keys are present (load factor of the bins is 0.5)
+    const int keys_per_thread = num_bins * bin_capacity / num_threads;
+    std::unique_ptr<Set> set = std::make_unique<Set>(num_insert_loop_iterations);
+    for (int i = 0; i < num_threads * keys_per_thread; i += 2)
+    {
+        set->insert(i);
+    }
+    const double mops = run_mixed_workload(*set, num_threads, read_ratio, operations_per_thread, keys_per_thread);
+    csv_file << name << "," << num_threads << "," << read_ratio << "," << mops << "\n";
+    std::cout << name << " threads=" << num_threads << " read_ratio=" << read_ratio << " " << mops << " Mops/s\n";
+}
+
+int main()
+{
+    // Open the output CSV file
+    std::ofstream csv_file("data.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "implementation,num_threads,read_ratio,mops\n";
+
+    std::vector<int> thread_counts{1, 2, 4, 8, 16, 32, 64};
+    std::vector<double> read_ratios{0.5, 0.9, 0.99};
+
+    for (double read_ratio : read_ratios)
+    {
+        for (int num_threads : thread_counts)
+        {
+            run_experiment<MutexBackyard>(csv_file, "mutex", num_threads, read_ratio);
+            run_experiment<StripedBackyard>(csv_file, "striped", num_threads, read_ratio);
+            run_experiment<ShardedSet>(csv_file, "sharded", num_threads, read_ratio);
+        }
+    }
+
+    // Close the file
+    csv_file.close();
+
+    // read scaling with a single writer
+    std::ofstream readers_csv_file("data_readers.csv");
+    if (!readers_csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    readers_csv_file << "implementation,num_readers,read_mops\n";
+    for (int num_readers : thread_counts)
+    {
+        run_read_experiment<MutexBackyard>(readers_csv_file, "mutex", num_readers);
+        run_read_experiment<StripedBackyard>(readers_csv_file, "striped", num_readers);
+        run_read_experiment<OptimisticBackyard>(readers_csv_file, "optimistic", num_readers);
+    }
+    readers_csv_file.close();
+
+    return 1;
+}
@@ -0,0 +1,105 @@
+#include <vector>
+#include <random>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include "../../src/backyard.h"
+#include "../../src/background_backyard.h"
+#include "../../src/workload.h"
+
+constexpr int num_bins = 1 << 14;
+constexpr int bin_capacity = 8;
+constexpr int size_cuckoo_tables = 1 << 14;
+constexpr int n_queue = 1000;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 1000;
+constexpr int n_cdm = 1000;
+constexpr int k_cdm = 20;
+constexpr int num_insert_loop_iterations = 16;
+
+using InlineSet = BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                        num_elems_cdm, n_cdm, k_cdm>;
+using BackgroundSet = BackgroundDrainedBackyard<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                                num_elems_cdm, n_cdm, k_cdm>;
+
+// returns the latency of every insert in nanoseconds, the request thread works for think_time_ns between two inserts
+template <typename Set>
+std::vector<double> measure_insert_latencies(Set &set, const std::vector<uint32_t> &input, int think_time_ns)
+{
+    std::vector<double> latencies;
+    latencies.reserve(input.size());
+    for (uint32_t value : input)
+    {
+        const auto think_until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(think_time_ns);
+        while (std::chrono::steady_clock::now() < think_until)
+        {
+        }
+        const auto start = std::chrono::steady_clock::now();
+        set.insert(value);
+        const std::chrono::duration<double, std::nano> nanoseconds = std::chrono::steady_clock::now() - start;
+        latencies.push_back(nanoseconds.count());
+    }
+    return latencies;
+}
+
+double percentile(std::vector<double> &values, double p)
+{
+    const std::size_t index = std::min(values.size() - 1, std::size_t(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void write_row(std::ofstream &csv_file, const std::string &name, double load_factor, int think_time_ns,
+               std::vector<double> latencies, long long lagging_inserts)
+{
+    const double p50 = percentile(latencies, 0.5);
+    const double p99 = percentile(latencies, 0.99);
+    const double max = *std::max_element(latencies.begin(), latencies.end());
+    csv_file << name << "," << load_factor << "," << think_time_ns << "," << p50 << "," << p99 << "," << max << "," << lagging_inserts << "\n";
+    std::cout << name << " load_factor=" << load_factor << " think_time=" << think_time_ns << "ns p50=" << p50 << "ns p99=" << p99 << "ns max=" << max
+              << "ns lagging=" << lagging_inserts << "\n";
+}
+
+int main()
+{
+    // Open the output CSV file
+    std::ofstream csv_file("data.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "implementation,load_factor,think_time_ns,p50_ns,p99_ns,max_ns,lagging_inserts\n";
+
+    // load factors relative to the capacity of the bins
+    std::vector<double> load_factors{0.5, 0.7, 0.8, 0.9, 0.95};
+    // 0: inserts back to back, the drainer can't keep up and inserts fall back to draining themselves
+    std::vector<int> think_times_ns{0, 1000};
+    for (int think_time_ns : think_times_ns)
+    {
+        for (double load_factor : load_factors)
+        {
+            const std::vector<uint32_t> input =
+                DistinctKeys<uint32_t>(0).generate(0, load_factor * num_bins * bin_capacity);
+
+            std::unique_ptr<InlineSet> inline_set = std::make_unique<InlineSet>(num_insert_loop_iterations);
+            write_row(csv_file, "inline", load_factor, think_time_ns,
+                      measure_insert_latencies(*inline_set, input, think_time_ns), 0);
+
+            std::unique_ptr<BackgroundSet> background_set = std::make_unique<BackgroundSet>(num_insert_loop_iterations);
+            std::vector<double> latencies = measure_insert_latencies(*background_set, input, think_time_ns);
+            background_set->wait_until_drained();
+            write_row(csv_file, "background", load_factor, think_time_ns, std::move(latencies),
+                      background_set->lagging_inserts());
+        }
+    }
+
+    // Close the file
+    csv_file.close();
+
+    return 1;
+}
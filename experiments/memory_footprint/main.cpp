@@ -0,0 +1,91 @@
+#include <array>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <utility>
+#include "../../src/backyard.h"
+#include "../../src/quotient_bin.h"
+
+// same parameter grid as experiments/auxiliary_structures_size
+constexpr std::array<int, 11> bin_capacities{1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+constexpr std::array<int, 11> sizes_cuckoo_tables{2453, 1804, 1303, 1071, 930, 762, 661, 542, 702, 384, 333};
+constexpr int num_insertions = 10000;
+constexpr int n_queue = 200;
+constexpr int k_queue = 20;
+constexpr int num_elems_cdm = 500;
+constexpr int n_cdm = 200;
+constexpr int k_cdm = 20;
+
+// bits per key of every part of the set when it holds num_keys keys (the memory only depends on the parameters)
+void write_memory_usage(std::ofstream &csv_file, const std::string &bins_layout, int bin_capacity,
+                        int size_cuckoo_tables, const MemoryUsage &usage, double num_keys)
+{
+    const double lower_bound = lower_bound_bits_per_key(32, num_keys);
+    const MemoryUsage without_hash_functions = [&usage]()
+    {
+        MemoryUsage rest = usage;
+        rest.hash_functions = 0;
+        return rest;
+    }();
+    csv_file << bins_layout << "," << bin_capacity << "," << num_insertions / bin_capacity << ","
+             << size_cuckoo_tables << "," << num_keys;
+    for (std::size_t bytes : {usage.bins_payload, usage.bins_metadata, usage.cuckoo_tables_payload,
+                              usage.cuckoo_tables_overhead, usage.queue_nodes, usage.cdm_nodes, usage.cdm_arrays,
+                              usage.hash_functions, usage.other})
+    {
+        csv_file << "," << bytes * 8.0 / num_keys;
+    }
+    csv_file << "," << usage.bits_per_key(num_keys) << "," << without_hash_functions.bits_per_key(num_keys) << ","
+             << lower_bound << "," << usage.bits_per_key(num_keys) / lower_bound << "\n";
+    std::cout << bins_layout << " bin_capacity=" << bin_capacity << ": " << usage.bits_per_key(num_keys)
+              << " bits per key (" << without_hash_functions.bits_per_key(num_keys)
+              << " without hash functions), lower bound " << lower_bound << "\n";
+}
+
+template <int experiment>
+void write_experiment(std::ofstream &csv_file)
+{
+    constexpr int bin_capacity = bin_capacities[experiment];
+    constexpr int num_bins = num_insertions / bin_capacity;
+    constexpr int size_cuckoo_tables = sizes_cuckoo_tables[experiment];
+    using Simple = BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                         num_elems_cdm, n_cdm, k_cdm>;
+    using Quotient = BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                           num_elems_cdm, n_cdm, k_cdm,
+                                           QuotientBinCollection<uint32_t, num_bins, bin_capacity>>;
+    for (double load_factor : {0.5, 0.9, 1.0})
+    {
+        write_memory_usage(csv_file, "simple", bin_capacity, size_cuckoo_tables, Simple::memory_usage(),
+                           load_factor * num_insertions);
+        write_memory_usage(csv_file, "quotient", bin_capacity, size_cuckoo_tables, Quotient::memory_usage(),
+                           load_factor * num_insertions);
+    }
+}
+
+template <std::size_t... experiments>
+void write_experiments(std::ofstream &csv_file, std::index_sequence<experiments...>)
+{
+    (write_experiment<experiments>(csv_file), ...);
+}
+
+int main()
+{
+    // Open the output CSV file
+    std::ofstream csv_file("data.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "bins_layout,bin_capacity,num_bins,size_cuckoo_tables,num_keys,bins_payload,bins_metadata,"
+                "cuckoo_tables_payload,cuckoo_tables_overhead,queue_nodes,cdm_nodes,cdm_arrays,hash_functions,"
+                "other,bits_per_key,bits_per_key_without_hash_functions,lower_bound,ratio\n";
+
+    write_experiments(csv_file, std::make_index_sequence<bin_capacities.size()>());
+
+    // Close the file
+    csv_file.close();
+
+    return 1;
+}
@@ -0,0 +1,26 @@
+import os
+import pandas as pd
+import matplotlib.pyplot as plt
+
+folder = "experiments/memory_footprint/"
+os.makedirs(folder + "plots", exist_ok=True)
+
+# Load the data
+data = pd.read_csv(folder + "data.csv")
+parts = ["bins_payload", "bins_metadata", "cuckoo_tables_payload", "cuckoo_tables_overhead", "queue_nodes",
+         "cdm_nodes", "cdm_arrays", "hash_functions", "other"]
+
+# one stacked bar per bin capacity for a full set, one plot per bin layout
+for bins_layout, group in data[data["num_keys"] == data["num_keys"].max()].groupby("bins_layout"):
+    group = group.set_index("bin_capacity")
+    ax = group[parts].plot(kind="bar", stacked=True, figsize=(12, 8))
+    ax.plot(range(len(group)), group["lower_bound"], color="black", marker="o", label="lower bound")
+    ax.set_xlabel("Bin Capacity", fontsize=12)
+    ax.set_ylabel("Bits per Key", fontsize=12)
+    ax.set_title(f"Memory per key ({bins_layout} bins, {int(group['num_keys'].iloc[0])} keys)")
+    ax.legend()
+    ax.grid(True, axis="y")
+
+    # Save the plot
+    plt.savefig(folder + f"plots/bits_per_key_{bins_layout}.png", bbox_inches="tight")
+    plt.close()
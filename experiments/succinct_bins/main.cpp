@@ -0,0 +1,52 @@
+#include <array>
+#include <iostream>
+#include <fstream>
+#include <utility>
+#include "../../src/simple_bin.h"
+#include "../../src/quotient_bin.h"
+
+// bits per stored key of the first level for a set of num_elements keys at the given load factor
+template <typename T, int num_elements, int bin_capacity>
+void write_bits_per_key(std::ofstream &csv_file, double load_factor)
+{
+    constexpr int num_bins = num_elements / bin_capacity;
+    // SimpleBinCollection can't be instantiated for every key type, so the size of its bins is used directly
+    constexpr double simple_bits = sizeof(std::array<SimpleBin<T, bin_capacity>, num_bins>) * 8.0;
+    constexpr double quotient_bits = QuotientBinCollection<T, num_bins, bin_capacity>::size_in_bits();
+    const double stored_keys = num_elements * load_factor;
+
+    csv_file << sizeof(T) * 8 << "," << num_elements << "," << bin_capacity << "," << num_bins << ","
+             << QuotientBinCollection<T, num_bins, bin_capacity>::remainder_bits << ","
+             << simple_bits / stored_keys << "," << quotient_bits / stored_keys << ","
+             << quotient_bits / simple_bits << "\n";
+}
+
+template <typename T, int num_elements, int... bin_capacities>
+void write_bits_per_key_for_capacities(std::ofstream &csv_file, double load_factor)
+{
+    (write_bits_per_key<T, num_elements, bin_capacities>(csv_file, load_factor), ...);
+}
+
+int main()
+{
+    // Open the output CSV file
+    std::ofstream csv_file("data.csv");
+    if (!csv_file.is_open())
+    {
+        std::cerr << "Failed to open the file.\n";
+        return 1;
+    }
+    // Write the CSV header
+    csv_file << "key_bits,num_elements,bin_capacity,num_bins,remainder_bits,simple_bits_per_key,quotient_bits_per_key,ratio\n";
+
+    constexpr double load_factor = 0.9;
+    write_bits_per_key_for_capacities<uint32_t, 10000, 1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64>(csv_file, load_factor);
+    write_bits_per_key_for_capacities<uint32_t, 1000000, 1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64>(csv_file, load_factor);
+    write_bits_per_key_for_capacities<uint64_t, 10000, 1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64>(csv_file, load_factor);
+    write_bits_per_key_for_capacities<uint64_t, 1000000, 1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64>(csv_file, load_factor);
+
+    // Close the file
+    csv_file.close();
+
+    return 1;
+}
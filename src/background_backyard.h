@@ -0,0 +1,226 @@
+#ifndef background_backyard_
+#define background_backyard_
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "backyard.h"
+
+// BackyardCuckooHashing where insert only appends the item to a small append buffer under a lock of its own.
+// A background thread moves the buffered items into the queue and runs the insert loop in chunks of drain_steps
+// iterations, holding the lock of the set only for one chunk at a time. Lookups also search the append buffer
+// and the queue, so they are correct at any time.
+// If the queue grows beyond max_queue_size the drainer doesn't keep up. An insert that finds the append buffer
+// full then moves it into the queue and does drain_steps loop iterations itself, so the queue stays bounded, and
+// counts as lagging. Lock order is set -> append buffer.
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
+          int num_elems_cdm, int n_cdm, int k_cdm>
+class BackgroundDrainedBackyard
+{
+public:
+    static constexpr int append_buffer_capacity = 64;
+
+    // the drainer performs drain_steps loop iterations every time it holds the lock
+    BackgroundDrainedBackyard(int drain_steps, int max_queue_size = n_queue * k_queue / 2)
+        : backyard(drain_steps), drain_steps(drain_steps), max_queue_size(max_queue_size)
+    {
+        if (max_queue_size < 1 || max_queue_size + append_buffer_capacity >= n_queue * k_queue)
+        {
+            throw std::invalid_argument(
+                "Background Drained Backyard: queue limit plus append buffer has to be below the queue capacity");
+        }
+        append_buffer.reserve(append_buffer_capacity);
+        drainer = std::thread(&BackgroundDrainedBackyard::drain, this);
+    }
+
+    ~BackgroundDrainedBackyard()
+    {
+        {
+            std::lock_guard<std::mutex> append_lock(append_mutex);
+            stop = true;
+        }
+        work_available.notify_one();
+        drainer.join();
+    }
+
+    BackgroundDrainedBackyard(const BackgroundDrainedBackyard &) = delete;
+    BackgroundDrainedBackyard &operator=(const BackgroundDrainedBackyard &) = delete;
+
+    void insert(const T &item)
+    {
+        bool was_empty, full;
+        {
+            std::lock_guard<std::mutex> append_lock(append_mutex);
+            was_empty = append_buffer.empty();
+            append_buffer.push_back(item);
+            full = append_buffer.size() >= append_buffer_capacity;
+        }
+        // the drainer only sleeps while the append buffer is empty, so other inserts don't have to wake it
+        if (was_empty)
+        {
+            work_available.notify_one();
+        }
+        if (full)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            flush_append_buffer();
+            if (backyard.queue.size() > max_queue_size)
+            {
+                backyard.process_queue(drain_steps);
+                num_lagging_inserts.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool remove(const T &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flush_append_buffer();
+        const bool removed = backyard.remove(item);
+        // the removed element may have been the last one in the queue
+        if (backyard.queue.empty())
+        {
+            drained.notify_all();
+        }
+        return removed;
+    }
+
+    bool contains(const T &item) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (backyard.contains(item))
+        {
+            return true;
+        }
+        std::lock_guard<std::mutex> append_lock(append_mutex);
+        return std::find(append_buffer.begin(), append_buffer.end(), item) != append_buffer.end();
+    }
+
+    int size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flush_append_buffer();
+        return backyard.size();
+    }
+
+    // elements that wait to be placed, in the append buffer and in the queue
+    int queue_size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<std::mutex> append_lock(append_mutex);
+        return backyard.queue.size() + append_buffer.size();
+    }
+
+    // number of inserts that had to do work themselves since the drainer fell behind
+    long long lagging_inserts() const
+    {
+        return num_lagging_inserts.load(std::memory_order_relaxed);
+    }
+
+    // false if an insert had to help the drainer since the previous call or the backlog is above the limit
+    bool keeping_up() const
+    {
+        const long long lagging = lagging_inserts();
+        const bool lagged = lagging_inserts_at_last_check.exchange(lagging, std::memory_order_relaxed) != lagging;
+        return !lagged && queue_size() <= max_queue_size;
+    }
+
+    // blocks until the drainer emptied the append buffer and the queue, which never happens if the cuckoo tables
+    // are too small to hold every element that overflows its bin
+    void wait_until_drained() const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        drained.wait(lock, [this]()
+                     { return backyard.queue.empty() && append_buffer_empty(); });
+    }
+
+private:
+    // waits of the drainer while chunks make no progress, e.g. if every queued element belongs to a full bin and
+    // the cuckoo tables are full, double from min_backoff up to max_backoff
+    static constexpr std::chrono::microseconds min_backoff{50};
+    static constexpr std::chrono::microseconds max_backoff{10000};
+
+    BackyardCuckooHashing<T, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm>
+        backyard;
+    int drain_steps;
+    int max_queue_size;
+    std::atomic<long long> num_lagging_inserts = 0;
+    mutable std::atomic<long long> lagging_inserts_at_last_check = 0;
+
+    // guards backyard
+    mutable std::mutex mutex;
+    mutable std::condition_variable drained;
+
+    // guards append_buffer and stop
+    mutable std::mutex append_mutex;
+    std::vector<T> append_buffer;
+    std::condition_variable work_available;
+    bool stop = false;
+    std::thread drainer;
+
+    bool append_buffer_empty() const
+    {
+        std::lock_guard<std::mutex> append_lock(append_mutex);
+        return append_buffer.empty();
+    }
+
+    // moves the append buffer into the queue, has to be called with the lock of the set held
+    void flush_append_buffer()
+    {
+        std::lock_guard<std::mutex> append_lock(append_mutex);
+        for (const T &item : append_buffer)
+        {
+            backyard.enqueue(item);
+        }
+        append_buffer.clear();
+    }
+
+    void drain()
+    {
+        bool idle = true;
+        std::chrono::microseconds backoff = min_backoff;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> append_lock(append_mutex);
+                // the wait of an idle drainer is bounded as well, an insert that helped the drainer may have
+                // left elements in the queue after the drainer saw it empty
+                work_available.wait_for(append_lock, idle ? max_backoff : backoff, [this]()
+                                        { return stop || !append_buffer.empty(); });
+                if (stop)
+                {
+                    return;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            flush_append_buffer();
+            const int queue_size_before = backyard.queue.size();
+            const bool was_rehashing = backyard.is_rehashing();
+            backyard.process_queue(drain_steps);
+            idle = backyard.queue.empty() && !backyard.is_rehashing();
+            if (idle)
+            {
+                drained.notify_all();
+            }
+            // a migration step of a rehash counts as progress even though it adds elements to the queue
+            if (was_rehashing || backyard.queue.size() < queue_size_before)
+            {
+                backoff = std::chrono::microseconds(0);
+            }
+            else
+            {
+                backoff = std::clamp(backoff * 2, min_backoff, max_backoff);
+            }
+        }
+    }
+};
+
+#endif
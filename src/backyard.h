@@ -2,12 +2,27 @@
 #define backyard_
 
 #include <cstddef>
+#include <algorithm>
 #include <array>
+#include <fstream>
+#include <memory>
 #include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "hash.h"
+#include "backyard_stats.h"
+#include "backyard_trace.h"
 #include "cdm.h"
+#include "cow_array.h"
+#include "memory_usage.h"
 #include "queue.h"
+#include "serialization.h"
 #include "simple_bin.h"
 
 // Custom operator between optional<T> and T that only returns true
@@ -20,29 +35,67 @@ bool operator==(const std::optional<T> &opt, const T &value)
     {
         return false;
     }
-    // Otherwise, compare the value inside the optional
-    return opt.value() == value;
+    // Otherwise, compare the value inside the optional (unchecked, optimistic readers may see the optional
+    // being reset concurrently and discard the result afterwards, value() would throw)
+    return *opt == value;
 }
 
+// Bins is the first level of the construction, it defaults to one bin per element (see simple_bin.h for alternatives)
+// Array stores the cuckoo tables, CowArray makes snapshots cheap (see CowBackyardCuckooHashing below)
 template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
-          int num_elems_cdm, int n_cdm, int k_cdm>
+          int num_elems_cdm, int n_cdm, int k_cdm, typename Bins = SimpleBinCollection<T, num_bins, bin_capacity>,
+          template <typename, std::size_t> typename Array = std::array>
 class BackyardCuckooHashing
 {
 public:
-    BackyardCuckooHashing(int insert_loop_iterations) : insert_loop_iterations(insert_loop_iterations)
+    BackyardCuckooHashing(int insert_loop_iterations)
+        : BackyardCuckooHashing(insert_loop_iterations, insert_loop_iterations, 0, 0)
+    {
+    }
+
+    // Adaptive variant: insert performs min_insert_loop_iterations steps while the queue holds at most
+    // queue_low_watermark elements, and scales linearly up to max_insert_loop_iterations (hard upper bound)
+    // once the queue holds queue_high_watermark elements or more
+    BackyardCuckooHashing(int min_insert_loop_iterations, int max_insert_loop_iterations,
+                          int queue_low_watermark, int queue_high_watermark)
+        : insert_loop_iterations(min_insert_loop_iterations),
+          max_insert_loop_iterations(max_insert_loop_iterations),
+          queue_low_watermark(queue_low_watermark),
+          queue_high_watermark(queue_high_watermark)
     {
-        bins = SimpleBinCollection<T, num_bins, bin_capacity>();
+        if (min_insert_loop_iterations < 1 || max_insert_loop_iterations < min_insert_loop_iterations)
+        {
+            throw std::invalid_argument("Backyard Cuckoo Hashing: invalid insert loop iteration bounds");
+        }
+        if (queue_low_watermark < 0 || queue_high_watermark < queue_low_watermark)
+        {
+            throw std::invalid_argument("Backyard Cuckoo Hashing: invalid queue watermarks");
+        }
         cuckoo_tables_h[0].set_range(size_cuckoo_tables);
         cuckoo_tables_h[1].set_range(size_cuckoo_tables);
+        cuckoo_tables_epoch[0].fill(false);
+        cuckoo_tables_epoch[1].fill(false);
+        set_rehash_policy(0, 0, 1);
         _size = 0;
     }
 
     bool contains(const T &item) const
     {
-        return bins.contains(item) ||
-               cuckoo_tables[0][cuckoo_tables_h[0].hash(item)] == item ||
-               cuckoo_tables[1][cuckoo_tables_h[1].hash(item)] == item ||
-               queue.contains({item, true}) || queue.contains({item, false});
+#ifdef BACKYARD_STATS
+        // a snapshot may be read by many threads at once, so its lookups don't update the statistics
+        if (is_snapshot)
+        {
+            return lookup<false>(item);
+        }
+#endif
+        return lookup<true>(item);
+    }
+
+    // contains that doesn't update the statistics (see backyard_stats.h), for readers that must not write to the
+    // set, e.g. concurrent readers or readers of a read-only mapping
+    bool contains_without_stats(const T &item) const
+    {
+        return lookup<false>(item);
     }
 
     bool remove(const T &item)
@@ -52,20 +105,33 @@ public:
             --_size;
             return true;
         }
+        // lookups through a const reference, so copy-on-write storage isn't copied for elements that aren't there
+        const std::array<Array<std::optional<T>, size_cuckoo_tables>, 2> &tables = cuckoo_tables;
         uint32_t hash = cuckoo_tables_h[0].hash(item);
-        if (cuckoo_tables[0][hash] == item)
+        if (tables[0][hash] == item)
         {
             --_size;
             cuckoo_tables[0][hash].reset();
             return true;
         }
         hash = cuckoo_tables_h[1].hash(item);
-        if (cuckoo_tables[1][hash] == item)
+        if (tables[1][hash] == item)
         {
             --_size;
             cuckoo_tables[1][hash].reset();
             return true;
         }
+        // elements that were not migrated yet still sit at their position under the old hash functions
+        for (int side = 0; rehashing && side < 2; ++side)
+        {
+            hash = old_cuckoo_tables_h[side].hash(item);
+            if (tables[side][hash] == item)
+            {
+                --_size;
+                cuckoo_tables[side][hash].reset();
+                return true;
+            }
+        }
         if (queue.remove({item, true}))
         {
             --_size;
@@ -80,40 +146,93 @@ public:
     }
 
     void insert(const T &item)
+    {
+        BACKYARD_TRACE_EVENT(trace_insert_begin(item));
+        enqueue(item);
+        process_queue(current_insert_loop_iterations());
+        BACKYARD_TRACE_EVENT(trace_insert_end(item));
+    }
+
+    // Fills an empty set with keys (duplicates are ignored), the result is the same as inserting them one by one.
+    // If Bins supports it the bins are filled by num_threads threads in parallel and only the elements that
+    // don't fit into their bin go through the insert loop, otherwise all keys are inserted sequentially.
+    void build_from(std::span<const T> keys, int num_threads = std::thread::hardware_concurrency())
+    {
+        if (_size != 0)
+        {
+            throw std::runtime_error("Backyard Cuckoo Hashing: build_from needs an empty set");
+        }
+        if constexpr (requires { bins.bulk_insert(keys, num_threads); })
+        {
+            const std::vector<T> overflow = bins.bulk_insert(keys, std::max(num_threads, 1));
+            _size = bins.size();
+            BACKYARD_STAT(stats_counters.bin_placements += bins.size());
+            for (const T &item : overflow)
+            {
+                insert(item);
+            }
+        }
+        else
+        {
+            for (const T &item : keys)
+            {
+                insert(item);
+            }
+        }
+    }
+
+    // first half of insert: only appends the item to the queue (if it isn't present yet)
+    void enqueue(const T &item)
     {
         if (!contains(item))
         {
             queue.push_back({item, true});
+            BACKYARD_STAT(++stats_counters.queue_push_backs);
+            BACKYARD_TRACE_EVENT(trace_event(TraceEventType::queue_push_back, item, true));
+            BACKYARD_STAT(record_queue_size());
             ++_size;
         }
+    }
+
+    // second half of insert: moves elements from the queue into the bins and cuckoo tables
+    void process_queue(int iterations)
+    {
         std::optional<T> y;
         bool b = true;
         uint32_t hash = 0;
-        for (int i = 0; i < insert_loop_iterations; ++i)
+        for (int i = 0; i < iterations; ++i)
         {
             if (!y.has_value())
             {
                 if (queue.empty())
                 {
-                    return;
+                    break;
                 }
                 else
                 {
                     const std::pair<T, bool> temp = queue.pop_front().value();
                     y = temp.first;
                     b = temp.second;
+                    BACKYARD_TRACE_EVENT(trace_event(TraceEventType::queue_pop, temp.first, temp.second));
                 }
             }
             if (bins.insert(y.value()))
             {
+                BACKYARD_STAT(++stats_counters.bin_placements);
+                BACKYARD_TRACE_EVENT(trace_event(TraceEventType::bin_hit, y.value(), b));
                 y.reset();
             }
             else
             {
+                BACKYARD_TRACE_EVENT(trace_event(TraceEventType::bin_miss, y.value(), b));
                 hash = cuckoo_tables_h[b].hash(y.value());
-                if (!cuckoo_tables[b][hash].has_value())
+                // read through a const reference, copy-on-write storage is only copied when the slot is written
+                if (!std::as_const(cuckoo_tables)[b][hash].has_value())
                 {
                     cuckoo_tables[b][hash] = y;
+                    cuckoo_tables_epoch[b][hash] = epoch;
+                    BACKYARD_STAT(++stats_counters.cuckoo_table_placements);
+                    BACKYARD_TRACE_EVENT(trace_event(TraceEventType::cuckoo_placement, y.value(), b, hash));
                     cdm.reset();
                     y.reset();
                 }
@@ -121,15 +240,25 @@ public:
                 {
                     if (cdm.contains({y.value(), b}))
                     {
+                        BACKYARD_STAT(++stats_counters.cycle_detections);
+                        BACKYARD_STAT(++stats_counters.queue_push_backs);
+                        BACKYARD_TRACE_EVENT(trace_event(TraceEventType::cdm_hit, y.value(), b));
+                        BACKYARD_TRACE_EVENT(trace_event(TraceEventType::queue_push_back, y.value(), b));
                         queue.push_back({y.value(), b});
                         cdm.reset();
                         y.reset();
                     }
                     else
                     {
-                        T z = cuckoo_tables[b][hash].value();
+                        T z = std::as_const(cuckoo_tables)[b][hash].value();
                         cuckoo_tables[b][hash] = y;
+                        cuckoo_tables_epoch[b][hash] = epoch;
                         cdm.insert({y.value(), b});
+                        // the cdm holds the evictions of the current walk
+                        BACKYARD_STAT(++stats_counters.evictions);
+                        BACKYARD_STAT(stats_counters.longest_eviction_walk =
+                                          std::max<uint64_t>(stats_counters.longest_eviction_walk, cdm.size()));
+                        BACKYARD_TRACE_EVENT(trace_event(TraceEventType::displacement, y.value(), b, hash));
                         y = z;
                         b = !b;
                     }
@@ -140,23 +269,434 @@ public:
         if (y.has_value())
         {
             queue.push_front({y.value(), b});
+            BACKYARD_STAT(++stats_counters.queue_push_fronts);
+            BACKYARD_TRACE_EVENT(trace_event(TraceEventType::queue_push_front, y.value(), b));
+        }
+
+        maintain_hash_functions();
+        BACKYARD_STAT(record_queue_size());
+    }
+
+    // A rehash is started once the queue holds more than queue_threshold elements for patience consecutive
+    // inserts (patience <= 0 disables it, the default). During the migration every insert moves at most
+    // steps_per_insert slots of the cuckoo tables over to the new hash functions. New hash functions don't help a
+    // set that holds more elements than fit, so while the queue stays above the threshold another rehash only
+    // starts if the queue shrank since the previous one, and at most max_consecutive_rehashes in a row.
+    void set_rehash_policy(int queue_threshold, int patience, int steps_per_insert)
+    {
+        if (steps_per_insert < 1)
+        {
+            throw std::invalid_argument("Backyard Cuckoo Hashing: rehash needs at least one step per insert");
         }
+        rehash_queue_threshold = queue_threshold;
+        rehash_patience = patience;
+        rehash_steps_per_insert = steps_per_insert;
     }
 
-    int size()
+    // samples new hash functions for the cuckoo tables, the elements are migrated incrementally by later inserts
+    void start_rehash()
+    {
+        if (rehashing)
+        {
+            return;
+        }
+        old_cuckoo_tables_h = cuckoo_tables_h;
+        cuckoo_tables_h[0].randomize_parameters();
+        cuckoo_tables_h[1].randomize_parameters();
+        // slots written from now on carry the new epoch, all others still have to be migrated
+        epoch = !epoch;
+        rehash_cursor = 0;
+        rehashing = true;
+        queue_growth_streak = 0;
+        queue_size_at_rehash = queue.size();
+        ++consecutive_rehashes;
+        ++rehash_count;
+        // chains recorded by the cdm were computed under the old hash functions
+        cdm.reset();
+    }
+
+    bool is_rehashing() const
+    {
+        return rehashing;
+    }
+
+#ifdef BACKYARD_STATS
+    // counters since the set was created (see backyard_stats.h)
+    BackyardStats stats() const
+    {
+        BackyardStats snapshot = stats_counters;
+        snapshot.queue_rebuilds = queue.rebuilds();
+        snapshot.cdm_rebuilds = cdm.rebuilds();
+        snapshot.rehashes = rehash_count;
+        return snapshot;
+    }
+#endif
+
+#ifdef BACKYARD_TRACE
+    // events of the last inserts (see backyard_trace.h), e.g. trace().write(path) for tools/trace_dump
+    const TraceRing<BACKYARD_TRACE_CAPACITY> &trace() const
+    {
+        return trace_ring;
+    }
+#endif
+
+    int size() const
     {
         return _size;
     }
 
+    // Bytes used by the set, split by level and by payload, metadata and hash functions (see memory_usage.h).
+    // Copy-on-write storage is counted as if no chunk were shared.
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage = Bins::memory_usage();
+        usage += decltype(queue)::memory_usage();
+        usage += decltype(cdm)::memory_usage();
+        usage.cuckoo_tables_payload = 2 * sizeof(T) * size_cuckoo_tables;
+        usage.cuckoo_tables_overhead = 2 * storage_bytes<Array<std::optional<T>, size_cuckoo_tables>>() +
+                                       2 * storage_bytes<Array<bool, size_cuckoo_tables>>() -
+                                       usage.cuckoo_tables_payload;
+        // the hash functions in use and the previous ones, which are kept for the migration of a rehash
+        usage.hash_functions += sizeof(cuckoo_tables_h) + sizeof(old_cuckoo_tables_h);
+        usage.other += sizeof(BackyardCuckooHashing) - sizeof(queue) - sizeof(cdm) - sizeof(bins) -
+                       sizeof(cuckoo_tables) - sizeof(cuckoo_tables_epoch) - sizeof(cuckoo_tables_h) -
+                       sizeof(old_cuckoo_tables_h);
+        return usage;
+    }
+
+    // number of loop iterations the next insert will perform given the current queue size
+    int current_insert_loop_iterations() const
+    {
+        const int queue_size = queue.size();
+        if (queue_size <= queue_low_watermark)
+        {
+            return insert_loop_iterations;
+        }
+        if (queue_size >= queue_high_watermark)
+        {
+            return max_insert_loop_iterations;
+        }
+        return insert_loop_iterations + (max_insert_loop_iterations - insert_loop_iterations) *
+                                            (queue_size - queue_low_watermark) /
+                                            (queue_high_watermark - queue_low_watermark);
+    }
+
+    // calls f for every element (in the bins, the cuckoo tables and the queue)
+    template <typename F>
+    void for_each(F f) const
+    {
+        bins.for_each(f);
+        for (const Array<std::optional<T>, size_cuckoo_tables> &table : cuckoo_tables)
+        {
+            for (int slot = 0; slot < size_cuckoo_tables; ++slot)
+            {
+                if (table[slot].has_value())
+                {
+                    f(table[slot].value());
+                }
+            }
+        }
+        for (const std::pair<T, bool> &entry : queue.to_vector())
+        {
+            f(entry.first);
+        }
+    }
+
+    // Point-in-time copy of the set that stays unchanged while this set is modified, e.g. for a reader in another
+    // thread. With copy-on-write storage (CowBackyardCuckooHashing) the bins and cuckoo tables share their chunks
+    // with the set, so a snapshot costs a pointer per chunk plus the copies of the chunks written afterwards
+    // (the queue, cdm and hash functions are copied). Has to be called by the thread that modifies the set.
+    // Lookups on a snapshot don't write to it (not even the statistics), so any number of threads can read it.
+    std::shared_ptr<const BackyardCuckooHashing> snapshot() const
+    {
+        std::shared_ptr<BackyardCuckooHashing> copy = std::make_shared<BackyardCuckooHashing>(*this);
+        BACKYARD_STAT(copy->is_snapshot = true);
+        return copy;
+    }
+
+    // Writes a snapshot: a header with the format version and the template parameters, followed by the bins,
+    // cuckoo tables and all hash functions as raw memory, and the queue contents in order with their positions
+    // (the loaded queue is laid out exactly like the saved one). A rehash in progress is saved with it (the old
+    // hash functions, the epoch of every slot and the migration cursor). Not saved are the contents of the cdm
+    // (the eviction walk in progress, the loaded set starts a new one), the statistics, the trace and the rebuild
+    // counters of the queue and cdm.
+    void save(const std::string &path) const
+    {
+        static_assert(std::is_trivially_copyable_v<Bins> && std::is_trivially_copyable_v<decltype(cuckoo_tables)>,
+                      "Backyard Cuckoo Hashing: only sets stored in std::array can be saved");
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+        {
+            throw std::runtime_error("Backyard Cuckoo Hashing: can't open " + path);
+        }
+        write_raw(out, snapshot_magic);
+        write_raw(out, snapshot_version);
+        write_raw(out, snapshot_parameters());
+
+        write_raw(out, bins);
+        write_raw(out, cuckoo_tables_h);
+        write_raw(out, cuckoo_tables);
+        write_raw(out, cuckoo_tables_epoch);
+        write_raw(out, old_cuckoo_tables_h);
+        write_raw(out, epoch);
+        write_raw(out, rehashing);
+        write_raw(out, rehash_cursor);
+        write_raw(out, rehash_count);
+        write_raw(out, rehash_queue_threshold);
+        write_raw(out, rehash_patience);
+        write_raw(out, rehash_steps_per_insert);
+        write_raw(out, queue_growth_streak);
+        write_raw(out, consecutive_rehashes);
+        write_raw(out, queue_size_at_rehash);
+        write_raw(out, insert_loop_iterations);
+        write_raw(out, max_insert_loop_iterations);
+        write_raw(out, queue_low_watermark);
+        write_raw(out, queue_high_watermark);
+        write_raw(out, _size);
+        queue.save(out);
+        cdm.save(out);
+        if (!out.flush())
+        {
+            throw std::runtime_error("Backyard Cuckoo Hashing: writing " + path + " failed");
+        }
+    }
+
+    // Replaces the contents of this set with a snapshot written by save. Nothing is rehashed, the bins and
+    // cuckoo tables are read back as they were. Throws if the snapshot was written by a different version or
+    // configuration, the set is unusable if reading fails halfway through.
+    void load(const std::string &path)
+    {
+        static_assert(std::is_trivially_copyable_v<Bins> && std::is_trivially_copyable_v<decltype(cuckoo_tables)>,
+                      "Backyard Cuckoo Hashing: only sets stored in std::array can be loaded");
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            throw std::runtime_error("Backyard Cuckoo Hashing: can't open " + path);
+        }
+        uint32_t magic, version;
+        decltype(snapshot_parameters()) parameters;
+        read_raw(in, magic);
+        read_raw(in, version);
+        if (magic != snapshot_magic || version != snapshot_version)
+        {
+            throw std::runtime_error("Backyard Cuckoo Hashing: " + path + " is no snapshot of this version");
+        }
+        read_raw(in, parameters);
+        if (parameters != snapshot_parameters())
+        {
+            throw std::runtime_error("Backyard Cuckoo Hashing: " + path + " was written with different parameters");
+        }
+
+        read_raw(in, bins);
+        read_raw(in, cuckoo_tables_h);
+        read_raw(in, cuckoo_tables);
+        read_raw(in, cuckoo_tables_epoch);
+        read_raw(in, old_cuckoo_tables_h);
+        read_raw(in, epoch);
+        read_raw(in, rehashing);
+        read_raw(in, rehash_cursor);
+        read_raw(in, rehash_count);
+        read_raw(in, rehash_queue_threshold);
+        read_raw(in, rehash_patience);
+        read_raw(in, rehash_steps_per_insert);
+        read_raw(in, queue_growth_streak);
+        read_raw(in, consecutive_rehashes);
+        read_raw(in, queue_size_at_rehash);
+        read_raw(in, insert_loop_iterations);
+        read_raw(in, max_insert_loop_iterations);
+        read_raw(in, queue_low_watermark);
+        read_raw(in, queue_high_watermark);
+        read_raw(in, _size);
+        queue.load(in);
+        cdm.load(in);
+    }
+
     ConstantTimeQueue<std::pair<T, bool>, n_queue, k_queue> queue;
     CycleDetectionMechanism<std::pair<T, bool>, num_elems_cdm, n_cdm, k_cdm> cdm;
-    SimpleBinCollection<T, num_bins, bin_capacity> bins;
+    Bins bins;
     std::array<TornadoHash<T>, 2> cuckoo_tables_h;
-    std::array<std::array<std::optional<T>, size_cuckoo_tables>, 2> cuckoo_tables;
+    std::array<Array<std::optional<T>, size_cuckoo_tables>, 2> cuckoo_tables;
+    // epoch (hash function generation) under which the element in a slot was placed
+    std::array<Array<bool, size_cuckoo_tables>, 2> cuckoo_tables_epoch;
+    std::array<TornadoHash<T>, 2> old_cuckoo_tables_h;
+    bool epoch = false;
+    bool rehashing = false;
+    int rehash_cursor = 0;
+    int rehash_count = 0;
+    static constexpr int max_consecutive_rehashes = 4;
+    int rehash_queue_threshold;
+    int rehash_patience;
+    int rehash_steps_per_insert;
+    int queue_growth_streak = 0;
+    // rehashes since the queue was last at the threshold, and the queue size when the last one started
+    int consecutive_rehashes = 0;
+    int queue_size_at_rehash = 0;
     int insert_loop_iterations;
+    int max_insert_loop_iterations;
+    int queue_low_watermark;
+    int queue_high_watermark;
     int _size;
 
 private:
+    template <bool record_stats>
+    bool lookup(const T &item) const
+    {
+        if constexpr (record_stats)
+        {
+            BACKYARD_STAT(++stats_counters.bin_probes);
+        }
+        if (bins.contains(item))
+        {
+            return true;
+        }
+        if constexpr (record_stats)
+        {
+            BACKYARD_STAT(++stats_counters.cuckoo_table_probes);
+        }
+        if (cuckoo_tables[0][cuckoo_tables_h[0].hash(item)] == item ||
+            cuckoo_tables[1][cuckoo_tables_h[1].hash(item)] == item ||
+            (rehashing && (cuckoo_tables[0][old_cuckoo_tables_h[0].hash(item)] == item ||
+                           cuckoo_tables[1][old_cuckoo_tables_h[1].hash(item)] == item)))
+        {
+            return true;
+        }
+        if constexpr (record_stats)
+        {
+            BACKYARD_STAT(++stats_counters.queue_probes);
+        }
+        return queue.contains({item, true}) || queue.contains({item, false});
+    }
+
+#ifdef BACKYARD_STATS
+    mutable BackyardStats stats_counters;
+    bool is_snapshot = false;
+
+    void record_queue_size()
+    {
+        stats_counters.peak_queue_size = std::max<uint64_t>(stats_counters.peak_queue_size, queue.size());
+    }
+#endif
+
+#ifdef BACKYARD_TRACE
+    TraceRing<BACKYARD_TRACE_CAPACITY> trace_ring;
+    // events outside of insert (e.g. process_queue called by a background thread) carry the last insert number
+    uint32_t trace_insert_number = 0;
+    int trace_queue_rebuilds = 0;
+    int trace_cdm_rebuilds = 0;
+    int trace_rehashes = 0;
+
+    void trace_event(TraceEventType type, const T &item, int side, uint32_t slot = 0)
+    {
+        trace_ring.record({trace_key(item), trace_insert_number, slot, uint8_t(side), type});
+    }
+
+    // keys that aren't integers are recorded by their std::hash value
+    static uint32_t trace_key(const T &item)
+    {
+        if constexpr (std::is_integral_v<T>)
+        {
+            return uint32_t(item);
+        }
+        else
+        {
+            return uint32_t(std::hash<T>{}(item));
+        }
+    }
+
+    void trace_insert_begin(const T &item)
+    {
+        ++trace_insert_number;
+        trace_queue_rebuilds = queue.rebuilds();
+        trace_cdm_rebuilds = cdm.rebuilds();
+        trace_rehashes = rehash_count;
+        trace_event(TraceEventType::insert_begin, item, 0);
+    }
+
+    void trace_insert_end(const T &item)
+    {
+        if (queue.rebuilds() != trace_queue_rebuilds)
+        {
+            trace_event(TraceEventType::queue_rebuild, item, 0);
+        }
+        if (cdm.rebuilds() != trace_cdm_rebuilds)
+        {
+            trace_event(TraceEventType::cdm_rebuild, item, 0);
+        }
+        if (rehash_count != trace_rehashes)
+        {
+            trace_event(TraceEventType::rehash, item, 0);
+        }
+        trace_event(TraceEventType::insert_end, item, 0);
+    }
+#endif
+
+    // "BYCH" in little endian, the version has to be increased whenever the layout of a snapshot changes
+    static constexpr uint32_t snapshot_magic = 0x48435942;
+    static constexpr uint32_t snapshot_version = 4;
+
+    // a snapshot can only be loaded into a set with the same parameters and the same layout of everything that is
+    // written as raw memory (the size of the whole set also changes with members that aren't saved)
+    static constexpr std::array<uint64_t, 12> snapshot_parameters()
+    {
+        return {sizeof(T), sizeof(Bins), sizeof(cuckoo_tables_h), sizeof(cuckoo_tables), num_bins, bin_capacity,
+                size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm};
+    }
+
+    void maintain_hash_functions()
+    {
+        if (rehashing)
+        {
+            migrate(rehash_steps_per_insert);
+            return;
+        }
+        if (rehash_patience <= 0 || queue.size() <= rehash_queue_threshold)
+        {
+            queue_growth_streak = 0;
+            consecutive_rehashes = 0;
+            return;
+        }
+        if (++queue_growth_streak < rehash_patience)
+        {
+            return;
+        }
+        queue_growth_streak = 0;
+        if (consecutive_rehashes == 0 ||
+            (consecutive_rehashes < max_consecutive_rehashes && queue.size() < queue_size_at_rehash))
+        {
+            start_rehash();
+        }
+    }
+
+    // moves elements stored under the old hash functions into the queue from where the insert loop places
+    // them again using the new hash functions
+    void migrate(int steps)
+    {
+        for (int i = 0; i < steps && rehash_cursor < 2 * size_cuckoo_tables; ++i, ++rehash_cursor)
+        {
+            const int side = rehash_cursor / size_cuckoo_tables;
+            const int slot = rehash_cursor % size_cuckoo_tables;
+            if (std::as_const(cuckoo_tables)[side][slot].has_value() &&
+                std::as_const(cuckoo_tables_epoch)[side][slot] != epoch)
+            {
+                queue.push_back({cuckoo_tables[side][slot].value(), side == 1});
+                BACKYARD_STAT(++stats_counters.queue_push_backs);
+                BACKYARD_TRACE_EVENT(trace_event(TraceEventType::queue_push_back, cuckoo_tables[side][slot].value(),
+                                                 side == 1));
+                cuckoo_tables[side][slot].reset();
+            }
+        }
+        if (rehash_cursor == 2 * size_cuckoo_tables)
+        {
+            rehashing = false;
+        }
+    }
 };
 
+// BackyardCuckooHashing whose bins and cuckoo tables are stored in copy-on-write chunks, for cheap snapshots
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
+          int num_elems_cdm, int n_cdm, int k_cdm>
+using CowBackyardCuckooHashing =
+    BackyardCuckooHashing<T, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm,
+                          SimpleBinCollection<T, num_bins, bin_capacity, 1, CowArray>, CowArray>;
+
 #endif
\ No newline at end of file
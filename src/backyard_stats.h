@@ -0,0 +1,40 @@
+#ifndef backyard_stats_
+#define backyard_stats_
+
+#include <cstdint>
+
+// Counters of a BackyardCuckooHashing, see BackyardCuckooHashing::stats. They are only collected if
+// BACKYARD_STATS is defined before the headers are included (e.g. -DBACKYARD_STATS), otherwise the counting
+// statements and the counters themselves are compiled out and stats() doesn't exist.
+// contains updates counters too, readers that must not write to the set (OptimisticBackyardCuckooHashing,
+// SharedBackyard) use contains_without_stats.
+struct BackyardStats
+{
+    // lookups (contains, and the check for duplicates in insert) that had to search the level
+    uint64_t bin_probes = 0;
+    uint64_t cuckoo_table_probes = 0;
+    uint64_t queue_probes = 0;
+    // where the insert loop placed elements
+    uint64_t bin_placements = 0;
+    uint64_t cuckoo_table_placements = 0;
+    // elements moved to the other cuckoo table to make room, the longest sequence of them within one walk,
+    // and walks stopped by the cdm (the element goes back to the queue)
+    uint64_t evictions = 0;
+    uint64_t longest_eviction_walk = 0;
+    uint64_t cycle_detections = 0;
+    uint64_t queue_push_backs = 0;
+    uint64_t queue_push_fronts = 0;
+    uint64_t peak_queue_size = 0;
+    // new hash functions sampled by the queue, the cdm and the cuckoo tables (rehash)
+    uint64_t queue_rebuilds = 0;
+    uint64_t cdm_rebuilds = 0;
+    uint64_t rehashes = 0;
+};
+
+#ifdef BACKYARD_STATS
+#define BACKYARD_STAT(statement) statement
+#else
+#define BACKYARD_STAT(statement)
+#endif
+
+#endif
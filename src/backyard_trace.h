@@ -0,0 +1,196 @@
+#ifndef backyard_trace_
+#define backyard_trace_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "serialization.h"
+
+// Event trace of the inserts of a BackyardCuckooHashing, see BackyardCuckooHashing::trace. Events are only
+// recorded if BACKYARD_TRACE is defined before the headers are included (e.g. -DBACKYARD_TRACE), otherwise the
+// recording statements and the buffer are compiled out. tools/trace_dump turns a written trace into chain
+// lengths per insert and a timeline.
+
+enum class TraceEventType : uint8_t
+{
+    insert_begin,
+    insert_end,
+    // the insert loop tried to put an element into its bin
+    bin_hit,
+    bin_miss,
+    // an element was put into a free cuckoo table slot, or into an occupied one whose element is moved on
+    cuckoo_placement,
+    displacement,
+    // the cdm found the element in the current walk, it goes back to the queue
+    cdm_hit,
+    queue_push_back,
+    queue_push_front,
+    queue_pop,
+    // new hash functions of the queue, the cdm or the cuckoo tables
+    queue_rebuild,
+    cdm_rebuild,
+    rehash,
+    num_types
+};
+
+struct TraceEvent
+{
+    uint32_t key;
+    // number of the insert the event belongs to, counted from 1
+    uint32_t insert_number;
+    // position in the cuckoo tables (displacement and cuckoo_placement)
+    uint32_t slot;
+    uint8_t side;
+    TraceEventType type;
+};
+
+inline const char *trace_event_name(TraceEventType type)
+{
+    static constexpr std::array<const char *, (int)TraceEventType::num_types> names{
+        "insert_begin", "insert_end", "bin_hit", "bin_miss", "cuckoo_placement", "displacement", "cdm_hit",
+        "queue_push_back", "queue_push_front", "queue_pop", "queue_rebuild", "cdm_rebuild", "rehash"};
+    return names[(int)type];
+}
+
+// "BYTR" in little endian
+inline constexpr uint32_t trace_magic = 0x52545942;
+inline constexpr uint32_t trace_version = 1;
+
+inline void write_trace(const std::string &path, const std::vector<TraceEvent> &events)
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+    {
+        throw std::runtime_error("Trace: can't open " + path);
+    }
+    write_raw(out, trace_magic);
+    write_raw(out, trace_version);
+    write_items(out, events);
+    if (!out.flush())
+    {
+        throw std::runtime_error("Trace: writing " + path + " failed");
+    }
+}
+
+inline std::vector<TraceEvent> read_trace(const std::string &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        throw std::runtime_error("Trace: can't open " + path);
+    }
+    uint32_t magic;
+    uint32_t version;
+    read_raw(in, magic);
+    read_raw(in, version);
+    if (magic != trace_magic || version != trace_version)
+    {
+        throw std::runtime_error("Trace: " + path + " is no trace of this version");
+    }
+    return read_items<TraceEvent>(in);
+}
+
+// Keeps the last capacity events. One thread records, other threads can copy the events out at the same time
+// without locks (seqlock style): an event is stored in two atomic words, the number of events is increased
+// before they are written (started) and after (recorded). A copy drops the events that may have been
+// overwritten while it was taken.
+template <std::size_t capacity>
+class TraceRing
+{
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "TraceRing: capacity has to be a power of two");
+
+public:
+    TraceRing() = default;
+
+    // copies are taken by the recording thread (e.g. BackyardCuckooHashing::snapshot)
+    TraceRing(const TraceRing &other)
+    {
+        *this = other;
+    }
+
+    TraceRing &operator=(const TraceRing &other)
+    {
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            words[i][0].store(other.words[i][0].load(std::memory_order_relaxed), std::memory_order_relaxed);
+            words[i][1].store(other.words[i][1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        started.store(other.started.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        recorded.store(other.recorded.load(std::memory_order_acquire), std::memory_order_release);
+        return *this;
+    }
+
+    void record(const TraceEvent &event)
+    {
+        const uint64_t position = recorded.load(std::memory_order_relaxed);
+        started.store(position + 1, std::memory_order_relaxed);
+        // a reader that sees the new words also sees started
+        std::atomic_thread_fence(std::memory_order_release);
+        std::array<std::atomic<uint64_t>, 2> &slot = words[position & (capacity - 1)];
+        slot[0].store(uint64_t(event.key) | uint64_t(event.insert_number) << 32, std::memory_order_relaxed);
+        slot[1].store(uint64_t(event.slot) | uint64_t(event.side) << 32 | uint64_t(event.type) << 40,
+                      std::memory_order_relaxed);
+        recorded.store(position + 1, std::memory_order_release);
+    }
+
+    // the events still in the buffer, oldest first
+    std::vector<TraceEvent> events() const
+    {
+        const uint64_t end = recorded.load(std::memory_order_acquire);
+        const uint64_t begin = end > capacity ? end - capacity : 0;
+        std::vector<TraceEvent> copy;
+        copy.reserve(end - begin);
+        for (uint64_t position = begin; position < end; ++position)
+        {
+            const std::array<std::atomic<uint64_t>, 2> &slot = words[position & (capacity - 1)];
+            const uint64_t first = slot[0].load(std::memory_order_relaxed);
+            const uint64_t second = slot[1].load(std::memory_order_relaxed);
+            copy.push_back({uint32_t(first), uint32_t(first >> 32), uint32_t(second), uint8_t(second >> 32),
+                            TraceEventType(second >> 40)});
+        }
+        // the recorder may have written over the oldest events in the meantime
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t now = started.load(std::memory_order_relaxed);
+        if (now - begin > capacity)
+        {
+            copy.erase(copy.begin(), copy.begin() + std::min<uint64_t>(now - begin - capacity, copy.size()));
+        }
+        return copy;
+    }
+
+    // number of events recorded so far, including the ones that were overwritten
+    uint64_t size() const
+    {
+        return recorded.load(std::memory_order_acquire);
+    }
+
+    void write(const std::string &path) const
+    {
+        write_trace(path, events());
+    }
+
+private:
+    std::array<std::array<std::atomic<uint64_t>, 2>, capacity> words{};
+    std::atomic<uint64_t> started = 0;
+    std::atomic<uint64_t> recorded = 0;
+};
+
+#ifdef BACKYARD_TRACE
+#define BACKYARD_TRACE_EVENT(statement) statement
+#else
+#define BACKYARD_TRACE_EVENT(statement)
+#endif
+
+// events a set keeps, 16 bytes each
+#ifndef BACKYARD_TRACE_CAPACITY
+#define BACKYARD_TRACE_CAPACITY 4096
+#endif
+
+#endif
@@ -7,17 +7,21 @@
 #include <stdexcept>
 
 #include "hash.h"
+#include "memory_usage.h"
+#include "serialization.h"
 
+// points_to is the position in the arrays of the collection that refers to this node (-1 if there is none),
+// a position instead of a pointer keeps the collection valid when it is copied or mapped at another address
 template <typename T>
 class CdmNode
 {
 public:
     T data;
-    int *points_to;
+    int points_to;
 
     CdmNode()
     {
-        points_to = nullptr;
+        points_to = -1;
     }
 };
 
@@ -40,7 +44,7 @@ public:
         {
             return;
         }
-        if (members > num_elements)
+        if (members >= num_elements)
         {
             throw std::runtime_error("Constant Time Collection: too many elements inserted");
         }
@@ -50,14 +54,13 @@ public:
         for (int i = 0; i < k; ++i)
         {
             int position = get_position(i, h[i].hash(item));
-            int *a = &(arrays[position]);
-            CdmNode<T> b = elements[*a];
+            const int a = arrays[position];
 
             // this spot is empty
-            if (b.points_to != a || *a >= members)
+            if (a >= members || elements[a].points_to != position)
             {
                 arrays[position] = members;
-                elements[members].points_to = &(arrays[position]);
+                elements[members].points_to = position;
                 elements[members].data = item;
                 members++;
                 return;
@@ -73,13 +76,9 @@ public:
         for (int i = 0; i < k; ++i)
         {
             const int position = get_position(i, h[i].hash(item));
-            const int *a = &(arrays[position]);
-            // somehow I can get a seg fault here
-            // somehow there can be arbitrary elements in the variable arrays (large ones and negative ones)
-            // this happens if elements overflows (more elements in the collection that it was intialized with)
-            const CdmNode<T> b = elements[*a];
+            const int a = arrays[position];
 
-            if (b.points_to == a && b.data == item && *a < members)
+            if (a < members && elements[a].points_to == position && elements[a].data == item)
             {
                 return true;
             }
@@ -103,8 +102,37 @@ public:
         return members;
     }
 
+    // number of times the collection sampled new hash functions since it was created
+    int rebuilds() const
+    {
+        return rebuild_count;
+    }
+
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage;
+        usage.cdm_nodes = sizeof(elements);
+        usage.cdm_arrays = sizeof(arrays);
+        usage.hash_functions = sizeof(h);
+        usage.other = sizeof(ConstantTimeCollection) - sizeof(elements) - sizeof(arrays) - sizeof(h);
+        return usage;
+    }
+
+    // only the hash functions are stored, the collection is empty after loading
+    void save(std::ostream &out) const
+    {
+        write_raw(out, h);
+    }
+
+    void load(std::istream &in)
+    {
+        read_raw(in, h);
+        reset();
+    }
+
 private:
     int members = 0;
+    int rebuild_count = 0;
     std::array<CdmNode<T>, num_elements> elements;
     std::array<int, k * n> arrays;
     std::array<CarterWegmanHash<T>, k> h;
@@ -116,6 +144,7 @@ private:
 
     void rebuild(const T &item)
     {
+        ++rebuild_count;
         std::vector<T> items;
         items.reserve(members + 1);
         items.push_back(item);
@@ -152,6 +181,7 @@ public:
     void insert(const T &item)
     {
         collection.insert(item);
+        ++num_inserts;
     }
 
     // only returns true once lookup on the collection returned true at least one times
@@ -179,9 +209,40 @@ public:
         return collection.size();
     }
 
+    int rebuilds() const
+    {
+        return collection.rebuilds();
+    }
+
+    // evictions recorded since the cdm was created, unlike size() this isn't cleared by reset
+    long long inserts() const
+    {
+        return num_inserts;
+    }
+
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage = ConstantTimeCollection<T, num_elements, n, k>::memory_usage();
+        usage.other += sizeof(CycleDetectionMechanism) - sizeof(collection);
+        return usage;
+    }
+
+    // the cdm only describes the eviction walk in progress, which doesn't survive a snapshot
+    void save(std::ostream &out) const
+    {
+        collection.save(out);
+    }
+
+    void load(std::istream &in)
+    {
+        collection.load(in);
+        duplicate = false;
+    }
+
 private:
     ConstantTimeCollection<T, num_elements, n, k> collection;
     bool duplicate = false;
+    long long num_inserts = 0;
 };
 
 #endif
\ No newline at end of file
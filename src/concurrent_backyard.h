@@ -0,0 +1,228 @@
+#ifndef concurrent_backyard_
+#define concurrent_backyard_
+
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+#include "hash.h"
+#include "simple_bin.h"
+#include "backyard.h"
+
+// Bins of ConcurrentBackyardCuckooHashing: the bins are split into num_stripes groups of consecutive bins with
+// one lock each. For every bin the number of its elements that currently live in the backyard is counted (under
+// the lock of the bin's stripe). contains and remove have to be called with the stripe of the element's bin held,
+// insert is called by the insert loop of the backyard and only try_locks the stripe (an element whose stripe is
+// busy is treated as if its bin was full).
+template <typename T, int num_bins, int bin_capacity, int num_stripes>
+class StripedBinCollection
+{
+    static_assert(num_stripes >= 1 && num_stripes <= num_bins, "StripedBinCollection: invalid number of stripes");
+
+public:
+    StripedBinCollection()
+    {
+        bins.fill(SimpleBin<T, bin_capacity>{});
+        num_in_backyard.fill(0);
+        h.set_range(num_bins);
+    }
+
+    // moves an element of the backyard into its bin if the bin has space and its stripe is free
+    bool insert(const T &item)
+    {
+        const int bin = bin_index(item);
+        std::unique_lock<std::mutex> stripe_lock(stripe(bin), std::try_to_lock);
+        if (!stripe_lock.owns_lock() || !insert_into_locked_bin(bin, item))
+        {
+            return false;
+        }
+        --num_in_backyard[bin];
+        return true;
+    }
+
+    bool insert_into_locked_bin(int bin, const T &item)
+    {
+        if (!bins[bin].has_space())
+        {
+            return false;
+        }
+        bins[bin].insert(item);
+        return true;
+    }
+
+    bool remove(const T &item)
+    {
+        return bins[bin_index(item)].remove(item);
+    }
+
+    bool contains(const T &item) const
+    {
+        return bins[bin_index(item)].contains(item);
+    }
+
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (const SimpleBin<T, bin_capacity> &bin : bins)
+        {
+            bin.for_each(f);
+        }
+    }
+
+    int bin_index(const T &item) const
+    {
+        return h.hash(item);
+    }
+
+    // stripes cover consecutive bins, so neighbouring bins share a lock
+    std::mutex &stripe(int bin) const
+    {
+        return stripes[(long long)bin * num_stripes / num_bins].mutex;
+    }
+
+    // number of elements of each bin that are stored in the backyard, guarded by the stripe of the bin
+    std::array<int, num_bins> num_in_backyard;
+
+private:
+    struct alignas(64) Stripe
+    {
+        std::mutex mutex;
+    };
+
+    std::array<SimpleBin<T, bin_capacity>, num_bins> bins;
+    TornadoHash<T> h;
+    mutable std::array<Stripe, num_stripes> stripes;
+};
+
+// Thread-safe variant of BackyardCuckooHashing using lock striping (see StripedBinCollection), the backyard
+// (cuckoo tables, queue and cdm) has its own lock. While no element of a bin lives in the backyard an element of
+// the bin can't be there either, so operations on such a bin, the common case, only take the bin's stripe lock.
+// Everything else runs the operations of BackyardCuckooHashing (including the adaptive insert loop and rehashing)
+// under the backyard lock.
+// Lock order is stripe -> backyard. The insert loop holds the backyard lock and only try_locks stripes, so there
+// are no lock cycles.
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
+          int num_elems_cdm, int n_cdm, int k_cdm, int num_stripes = 64>
+class ConcurrentBackyardCuckooHashing
+{
+public:
+    ConcurrentBackyardCuckooHashing(int insert_loop_iterations) : backyard(insert_loop_iterations)
+    {
+    }
+
+    // adaptive insert loop, see BackyardCuckooHashing
+    ConcurrentBackyardCuckooHashing(int min_insert_loop_iterations, int max_insert_loop_iterations,
+                                    int queue_low_watermark, int queue_high_watermark)
+        : backyard(min_insert_loop_iterations, max_insert_loop_iterations, queue_low_watermark, queue_high_watermark)
+    {
+    }
+
+    // see BackyardCuckooHashing::set_rehash_policy, must not be called concurrently with other operations
+    void set_rehash_policy(int queue_threshold, int patience, int steps_per_insert)
+    {
+        backyard.set_rehash_policy(queue_threshold, patience, steps_per_insert);
+    }
+
+    bool contains(const T &item) const
+    {
+        const int bin = bins().bin_index(item);
+        std::lock_guard<std::mutex> stripe_lock(bins().stripe(bin));
+        if (bins().contains(item))
+        {
+            return true;
+        }
+        if (!bins().num_in_backyard[bin])
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> backyard_lock(backyard_mutex);
+        return backyard.contains(item);
+    }
+
+    bool remove(const T &item)
+    {
+        const int bin = bins().bin_index(item);
+        std::lock_guard<std::mutex> stripe_lock(bins().stripe(bin));
+        if (bins().remove(item))
+        {
+            --_size;
+            return true;
+        }
+        if (!bins().num_in_backyard[bin])
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> backyard_lock(backyard_mutex);
+        if (backyard.remove(item))
+        {
+            --bins().num_in_backyard[bin];
+            --_size;
+            return true;
+        }
+        return false;
+    }
+
+    void insert(const T &item)
+    {
+        const int bin = bins().bin_index(item);
+        std::unique_lock<std::mutex> stripe_lock(bins().stripe(bin));
+        if (bins().contains(item))
+        {
+            return;
+        }
+        // fast path: no element of this bin is in the backyard, so the item can't be there either
+        if (!bins().num_in_backyard[bin] && bins().insert_into_locked_bin(bin, item))
+        {
+            ++_size;
+            return;
+        }
+
+        std::lock_guard<std::mutex> backyard_lock(backyard_mutex);
+        // enqueue appends the item to the queue unless it is in the backyard already
+        const int queue_size = backyard.queue.size();
+        backyard.enqueue(item);
+        if (backyard.queue.size() != queue_size)
+        {
+            ++bins().num_in_backyard[bin];
+            ++_size;
+        }
+        // the insert loop try_locks stripes, so the stripe lock can't be held (a thread may not lock a mutex twice)
+        stripe_lock.unlock();
+        backyard.process_queue(backyard.current_insert_loop_iterations());
+    }
+
+    int size() const
+    {
+        return _size;
+    }
+
+    int rehash_count() const
+    {
+        std::lock_guard<std::mutex> backyard_lock(backyard_mutex);
+        return backyard.rehash_count;
+    }
+
+private:
+    using Bins = StripedBinCollection<T, num_bins, bin_capacity, num_stripes>;
+
+    // the bins are guarded by their stripes, everything else by backyard_mutex
+    mutable std::mutex backyard_mutex;
+    BackyardCuckooHashing<T, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm,
+                          k_cdm, Bins>
+        backyard;
+    std::atomic<int> _size = 0;
+
+    Bins &bins()
+    {
+        return backyard.bins;
+    }
+
+    const Bins &bins() const
+    {
+        return backyard.bins;
+    }
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef cow_array_
+#define cow_array_
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+
+// Fixed size array (same interface as the parts of std::array the data structures use) that is split into
+// chunks of about one page. Copies share all chunks, a chunk is only copied once one of the copies writes to it.
+// Copying a CowArray costs one pointer per chunk, so a snapshot of a large table is cheap and afterwards only
+// the chunks that are written are duplicated.
+// Non-const element access counts as a write. Copies can be read by other threads, but a CowArray and all
+// copies that are written have to be owned by one thread.
+template <typename T, std::size_t N>
+class CowArray
+{
+public:
+    // a power of two, so positions are split into chunk and offset with shifts
+    static constexpr std::size_t chunk_size = std::bit_floor(std::max<std::size_t>(4096 / sizeof(T), 1));
+    static constexpr std::size_t num_chunks = (N + chunk_size - 1) / chunk_size;
+
+    CowArray()
+    {
+        for (std::shared_ptr<Chunk> &chunk : chunks)
+        {
+            chunk = std::make_shared<Chunk>();
+        }
+    }
+
+    const T &operator[](std::size_t position) const
+    {
+        return (*chunks[position / chunk_size])[position % chunk_size];
+    }
+
+    T &operator[](std::size_t position)
+    {
+        return writable_chunk(position / chunk_size)[position % chunk_size];
+    }
+
+    void fill(const T &value)
+    {
+        for (std::shared_ptr<Chunk> &chunk : chunks)
+        {
+            chunk = std::make_shared<Chunk>();
+            chunk->fill(value);
+        }
+    }
+
+    static constexpr std::size_t size()
+    {
+        return N;
+    }
+
+    // copies every chunk that is shared with another CowArray, afterwards several threads can write to
+    // distinct positions at the same time
+    void unshare()
+    {
+        for (std::size_t c = 0; c < num_chunks; ++c)
+        {
+            writable_chunk(c);
+        }
+    }
+
+    // bytes of the object and of all chunks as if none of them were shared (a chunk is one allocation together
+    // with its reference counts)
+    static constexpr std::size_t storage_bytes()
+    {
+        return sizeof(CowArray) + num_chunks * (sizeof(Chunk) + 2 * sizeof(long));
+    }
+
+    // number of chunks that are shared with another CowArray
+    std::size_t shared_chunks() const
+    {
+        std::size_t count = 0;
+        for (const std::shared_ptr<Chunk> &chunk : chunks)
+        {
+            count += chunk.use_count() > 1;
+        }
+        return count;
+    }
+
+private:
+    using Chunk = std::array<T, chunk_size>;
+
+    std::array<std::shared_ptr<Chunk>, num_chunks> chunks;
+
+    Chunk &writable_chunk(std::size_t c)
+    {
+        if (chunks[c].use_count() > 1)
+        {
+            chunks[c] = std::make_shared<Chunk>(*chunks[c]);
+        }
+        else
+        {
+            // the last other owner may have just released the chunk in another thread, its reads have to
+            // happen before the writes of this one
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *chunks[c];
+    }
+};
+
+#endif
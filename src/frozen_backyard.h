@@ -0,0 +1,388 @@
+#ifndef frozen_backyard_
+#define frozen_backyard_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "backyard.h"
+#include "hash.h"
+#include "serialization.h"
+
+// Immutable lookup-only form of a BackyardCuckooHashing (see freeze below) that is used directly from a memory
+// mapped file. The file only contains offsets, no pointers, so it can be mapped anywhere
+// and shared by many processes through the page cache.
+// Layout: header, hash function of the bins, hash function of the backyard, then bins and backyard, each as
+// offsets (begin of every bin/bucket, no gaps between them) followed by the keys. Every section starts at a
+// multiple of 64 bytes.
+// The bins keep at most bin_capacity keys, all others are spread over the backyard buckets by a second hash
+// function (one bucket per key on average). There is no queue and no cdm, since nothing is ever inserted.
+template <typename T>
+class FrozenBackyard
+{
+    // the hash functions are stored as raw memory, which is only done for TornadoHash<uint32_t>
+    static_assert(std::is_same_v<T, uint32_t>, "FrozenBackyard is only defined for uint32_t keys");
+
+public:
+    // Maps the file, throws if it isn't a frozen backyard of this version and key type or if its sections don't
+    // fit into the file. Opening doesn't read the offsets of the bins and buckets, every lookup checks the two
+    // offsets it uses and verify checks all of them.
+    explicit FrozenBackyard(const std::string &path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Frozen Backyard: can't open " + path);
+        }
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) != 0 || (std::size_t)file_stat.st_size < sizeof(Header))
+        {
+            close(fd);
+            throw std::runtime_error("Frozen Backyard: " + path + " is too small");
+        }
+        mapping_size = file_stat.st_size;
+        void *address = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        // the mapping stays valid after closing the file
+        close(fd);
+        if (address == MAP_FAILED)
+        {
+            throw std::runtime_error("Frozen Backyard: can't map " + path);
+        }
+        mapping = static_cast<const std::byte *>(address);
+
+        std::memcpy(&header, mapping, sizeof(Header));
+        if (header.magic != magic || header.version != version || header.key_size != sizeof(T) ||
+            header.file_size != mapping_size || header.num_bins == 0 || header.num_buckets == 0 ||
+            header.bucket_keys_offset + header.num_backyard_keys * sizeof(T) != header.file_size)
+        {
+            munmap(const_cast<std::byte *>(mapping), mapping_size);
+            throw std::runtime_error("Frozen Backyard: " + path + " is no frozen backyard of this version");
+        }
+        if (!sections_fit())
+        {
+            munmap(const_cast<std::byte *>(mapping), mapping_size);
+            throw std::runtime_error("Frozen Backyard: " + path + " is corrupt, its sections don't fit into the file");
+        }
+        // the hash functions are small, copying them avoids reading objects that were never constructed
+        std::memcpy(&bins_h, mapping + header.bins_hash_offset, sizeof(bins_h));
+        std::memcpy(&backyard_h, mapping + header.backyard_hash_offset, sizeof(backyard_h));
+        bin_offsets = reinterpret_cast<const uint32_t *>(mapping + header.bin_offsets_offset);
+        bin_keys = reinterpret_cast<const T *>(mapping + header.bin_keys_offset);
+        bucket_offsets = reinterpret_cast<const uint32_t *>(mapping + header.bucket_offsets_offset);
+        bucket_keys = reinterpret_cast<const T *>(mapping + header.bucket_keys_offset);
+        // every bin and bucket a hash function can return has to exist
+        if (bins_h.range() != header.num_bins || backyard_h.range() != header.num_buckets)
+        {
+            munmap(const_cast<std::byte *>(mapping), mapping_size);
+            throw std::runtime_error("Frozen Backyard: " + path + " is corrupt, its hash functions don't match");
+        }
+    }
+
+    ~FrozenBackyard()
+    {
+        munmap(const_cast<std::byte *>(mapping), mapping_size);
+    }
+
+    FrozenBackyard(const FrozenBackyard &) = delete;
+    FrozenBackyard &operator=(const FrozenBackyard &) = delete;
+
+    // throws if the offsets of the bin or bucket of item are corrupt
+    bool contains(const T &item) const
+    {
+        const uint32_t bin = bins_h.hash(item);
+        const uint32_t bin_end = bin_offsets[bin + 1];
+        check_range(bin_offsets[bin], bin_end, header.num_keys - header.num_backyard_keys, header.bin_capacity);
+        for (uint32_t i = bin_offsets[bin]; i < bin_end; ++i)
+        {
+            if (bin_keys[i] == item)
+            {
+                return true;
+            }
+        }
+        // only keys of full bins are in the backyard
+        if (bin_end - bin_offsets[bin] < header.bin_capacity)
+        {
+            return false;
+        }
+        const uint32_t bucket = backyard_h.hash(item);
+        const uint32_t bucket_end = bucket_offsets[bucket + 1];
+        check_range(bucket_offsets[bucket], bucket_end, header.num_backyard_keys, UINT32_MAX);
+        for (uint32_t i = bucket_offsets[bucket]; i < bucket_end; ++i)
+        {
+            if (bucket_keys[i] == item)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t size() const
+    {
+        return header.num_keys;
+    }
+
+    // number of keys that didn't fit into their bin
+    std::size_t backyard_size() const
+    {
+        return header.num_backyard_keys;
+    }
+
+    // checks the offsets of all bins and buckets (reads the whole offset sections), throws if one is corrupt
+    void verify() const
+    {
+        if (!offsets_valid(bin_offsets, header.num_bins, header.num_keys - header.num_backyard_keys,
+                           header.bin_capacity) ||
+            !offsets_valid(bucket_offsets, header.num_buckets, header.num_backyard_keys, UINT32_MAX))
+        {
+            throw std::runtime_error("Frozen Backyard: corrupt file, its bins or buckets are invalid");
+        }
+    }
+
+    // Writes keys (without duplicates) in the frozen format. The bins get a new hash function, so the layout
+    // doesn't depend on the first level the keys came from.
+    static void write(const std::string &path, std::span<const T> keys, uint32_t num_bins, uint32_t bin_capacity)
+    {
+        if (num_bins == 0 || keys.size() >= UINT32_MAX)
+        {
+            throw std::invalid_argument("Frozen Backyard: invalid number of bins or keys");
+        }
+        TornadoHash<T> bins_h;
+        bins_h.set_range(num_bins);
+        std::vector<uint32_t> bin_of(keys.size());
+        std::vector<uint32_t> bin_offsets(num_bins + 1, 0);
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            bin_of[i] = bins_h.hash(keys[i]);
+            if (bin_offsets[bin_of[i] + 1] < bin_capacity)
+            {
+                ++bin_offsets[bin_of[i] + 1];
+            }
+        }
+        for (uint32_t bin = 0; bin < num_bins; ++bin)
+        {
+            bin_offsets[bin + 1] += bin_offsets[bin];
+        }
+
+        // fill the bins in input order, keys of full bins go to the backyard
+        std::vector<T> bin_keys(bin_offsets[num_bins]);
+        std::vector<uint32_t> next_slot(bin_offsets.begin(), bin_offsets.end() - 1);
+        std::vector<T> backyard_keys;
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            if (next_slot[bin_of[i]] < bin_offsets[bin_of[i] + 1])
+            {
+                bin_keys[next_slot[bin_of[i]]++] = keys[i];
+            }
+            else
+            {
+                backyard_keys.push_back(keys[i]);
+            }
+        }
+
+        const uint32_t num_buckets = std::max<std::size_t>(backyard_keys.size(), 1);
+        TornadoHash<T> backyard_h;
+        backyard_h.set_range(num_buckets);
+        std::vector<uint32_t> bucket_offsets(num_buckets + 1, 0);
+        for (const T &key : backyard_keys)
+        {
+            ++bucket_offsets[backyard_h.hash(key) + 1];
+        }
+        for (uint32_t bucket = 0; bucket < num_buckets; ++bucket)
+        {
+            bucket_offsets[bucket + 1] += bucket_offsets[bucket];
+        }
+        std::vector<T> bucket_keys(backyard_keys.size());
+        next_slot.assign(bucket_offsets.begin(), bucket_offsets.end() - 1);
+        for (const T &key : backyard_keys)
+        {
+            bucket_keys[next_slot[backyard_h.hash(key)]++] = key;
+        }
+
+        Header header{};
+        header.magic = magic;
+        header.version = version;
+        header.key_size = sizeof(T);
+        header.bin_capacity = bin_capacity;
+        header.num_bins = num_bins;
+        header.num_buckets = num_buckets;
+        header.num_keys = keys.size();
+        header.num_backyard_keys = backyard_keys.size();
+        std::size_t end = section_begin(sizeof(Header));
+        header.bins_hash_offset = end;
+        end = section_begin(end + sizeof(bins_h));
+        header.backyard_hash_offset = end;
+        end = section_begin(end + sizeof(backyard_h));
+        header.bin_offsets_offset = end;
+        end = section_begin(end + bin_offsets.size() * sizeof(uint32_t));
+        header.bin_keys_offset = end;
+        end = section_begin(end + bin_keys.size() * sizeof(T));
+        header.bucket_offsets_offset = end;
+        end = section_begin(end + bucket_offsets.size() * sizeof(uint32_t));
+        header.bucket_keys_offset = end;
+        header.file_size = end + bucket_keys.size() * sizeof(T);
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out)
+        {
+            throw std::runtime_error("Frozen Backyard: can't open " + path);
+        }
+        write_raw(out, header);
+        pad_to(out, header.bins_hash_offset);
+        write_raw(out, bins_h);
+        pad_to(out, header.backyard_hash_offset);
+        write_raw(out, backyard_h);
+        pad_to(out, header.bin_offsets_offset);
+        write_array(out, bin_offsets);
+        pad_to(out, header.bin_keys_offset);
+        write_array(out, bin_keys);
+        pad_to(out, header.bucket_offsets_offset);
+        write_array(out, bucket_offsets);
+        pad_to(out, header.bucket_keys_offset);
+        write_array(out, bucket_keys);
+        if (!out.flush())
+        {
+            throw std::runtime_error("Frozen Backyard: writing " + path + " failed");
+        }
+    }
+
+private:
+    // "BYFZ" in little endian
+    static constexpr uint32_t magic = 0x5a465942;
+    static constexpr uint32_t version = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t key_size;
+        uint32_t bin_capacity;
+        uint64_t num_bins;
+        uint64_t num_buckets;
+        uint64_t num_keys;
+        uint64_t num_backyard_keys;
+        // positions of the sections relative to the begin of the file
+        uint64_t bins_hash_offset;
+        uint64_t backyard_hash_offset;
+        uint64_t bin_offsets_offset;
+        uint64_t bin_keys_offset;
+        uint64_t bucket_offsets_offset;
+        uint64_t bucket_keys_offset;
+        uint64_t file_size;
+    };
+
+    Header header;
+    TornadoHash<T> bins_h;
+    TornadoHash<T> backyard_h;
+    const std::byte *mapping;
+    std::size_t mapping_size;
+    const uint32_t *bin_offsets;
+    const T *bin_keys;
+    const uint32_t *bucket_offsets;
+    const T *bucket_keys;
+
+    // sections are aligned, in order, don't overlap and end inside the file, checked without overflows
+    bool sections_fit() const
+    {
+        if (header.num_backyard_keys > header.num_keys || header.num_bins >= UINT32_MAX ||
+            header.num_buckets >= UINT32_MAX || header.num_keys >= UINT32_MAX)
+        {
+            return false;
+        }
+        const uint64_t num_bin_keys = header.num_keys - header.num_backyard_keys;
+        const std::array<std::pair<uint64_t, uint64_t>, 6> sections = {{
+            {header.bins_hash_offset, sizeof(bins_h)},
+            {header.backyard_hash_offset, sizeof(backyard_h)},
+            {header.bin_offsets_offset, (header.num_bins + 1) * sizeof(uint32_t)},
+            {header.bin_keys_offset, num_bin_keys * sizeof(T)},
+            {header.bucket_offsets_offset, (header.num_buckets + 1) * sizeof(uint32_t)},
+            {header.bucket_keys_offset, header.num_backyard_keys * sizeof(T)},
+        }};
+        uint64_t end = sizeof(Header);
+        for (const auto &[offset, size] : sections)
+        {
+            if (offset % 64 != 0 || offset < end || offset > header.file_size || size > header.file_size - offset)
+            {
+                return false;
+            }
+            end = offset + size;
+        }
+        return true;
+    }
+
+    // offsets of num_ranges ranges without gaps that cover [0, num_keys), each with at most max_range_size keys
+    static bool offsets_valid(const uint32_t *offsets, uint64_t num_ranges, uint64_t num_keys,
+                              uint32_t max_range_size)
+    {
+        if (offsets[0] != 0 || offsets[num_ranges] != num_keys)
+        {
+            return false;
+        }
+        for (uint64_t i = 0; i < num_ranges; ++i)
+        {
+            if (offsets[i + 1] < offsets[i] || offsets[i + 1] - offsets[i] > max_range_size)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the keys of a bin or bucket lie within the num_keys keys of its section
+    static void check_range(uint32_t begin, uint32_t end, uint64_t num_keys, uint32_t max_range_size)
+    {
+        if (end < begin || end > num_keys || end - begin > max_range_size)
+        {
+            throw std::runtime_error("Frozen Backyard: corrupt file, a bin or bucket lies outside of its keys");
+        }
+    }
+
+    static std::size_t section_begin(std::size_t position)
+    {
+        return (position + 63) / 64 * 64;
+    }
+
+    static void pad_to(std::ostream &out, std::size_t position)
+    {
+        while ((std::size_t)out.tellp() < position)
+        {
+            out.put(0);
+        }
+    }
+
+    template <typename U>
+    static void write_array(std::ostream &out, const std::vector<U> &values)
+    {
+        out.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(U));
+    }
+};
+
+// Writes all elements of set into an immutable file that FrozenBackyard answers lookups from, only for uint32_t
+// keys. A free function, so backyard.h doesn't depend on the POSIX headers of the memory mapping.
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
+          int num_elems_cdm, int n_cdm, int k_cdm, typename Bins, template <typename, std::size_t> typename Array>
+void freeze(const BackyardCuckooHashing<T, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm,
+                                        n_cdm, k_cdm, Bins, Array> &set,
+            const std::string &path)
+{
+    std::vector<T> elements;
+    elements.reserve(set.size());
+    set.for_each([&elements](const T &item)
+                 { elements.push_back(item); });
+    FrozenBackyard<T>::write(path, elements, num_bins, bin_capacity);
+}
+
+#endif
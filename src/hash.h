@@ -2,12 +2,38 @@
 #define hash_
 
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <random>
+#include <limits>
+#include <type_traits>
 #include "large_primes.h"
 
-// Define a static random number generator with a fixed seed to be able to reproduce results.
-static std::mt19937_64 gen(42);
+// Deterministic pseudo random numbers that can be computed at compile time (splitmix64), advances state
+constexpr uint64_t splitmix64(uint64_t &state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// number of generators seeded so far, shared by all threads
+inline std::atomic<uint64_t> num_generators = 0;
+
+// The first generator gets the fixed seed 42 to be able to reproduce results, every later one a seed of its own
+// derived from its number, so generators of different threads draw independent hash functions and a rehash never
+// replays the draws of another thread. The numbers depend on the order in which threads first use their
+// generator, threads that have to be reproducible seed gen themselves (e.g. the workers of ShardedBackyard).
+inline uint64_t next_generator_seed()
+{
+    uint64_t index = num_generators.fetch_add(1, std::memory_order_relaxed);
+    return index == 0 ? 42 : splitmix64(index);
+}
+
+// Every thread has its own generator, so instances can be created and rebuilt in parallel.
+static thread_local std::mt19937_64 gen(next_generator_seed());
 
 uint64_t sample_prime()
 {
@@ -126,6 +152,31 @@ private:
     uint64_t a, b, p;
 };
 
+// Specialization for (y, b) pairs of other keys (e.g. std::string), y is reduced to 32 bits by std::hash first
+template <typename T>
+class CarterWegmanHash<std::pair<T, bool>>
+{
+public:
+    void set_range(uint32_t m)
+    {
+        h.set_range(m);
+    }
+
+    void randomize_parameters()
+    {
+        h.randomize_parameters();
+    }
+
+    uint32_t hash(const std::pair<T, bool> &item) const
+    {
+        const uint64_t digest = std::hash<T>{}(item.first);
+        return h.hash({uint32_t(digest ^ (digest >> 32)), item.second});
+    }
+
+private:
+    CarterWegmanHash<std::pair<uint32_t, bool>> h;
+};
+
 // Abstract base class template
 template <typename T>
 class TornadoHash
@@ -148,11 +199,25 @@ public:
         randomize_parameters();
     }
 
-    void set_range(uint32_t m)
+    // parameters derived from seed instead of the global generator, can be used in constant expressions
+    constexpr explicit TornadoHash(uint64_t seed) : random_bits{}, modulus(1)
+    {
+        for (uint64_t &elem : random_bits)
+        {
+            elem = splitmix64(seed);
+        }
+    }
+
+    constexpr void set_range(uint32_t m)
     {
         modulus = m;
     }
 
+    constexpr uint32_t range() const
+    {
+        return modulus;
+    }
+
     void randomize_parameters()
     {
         std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
@@ -163,7 +228,7 @@ public:
         }
     }
 
-    uint32_t hash(const uint32_t &item) const
+    constexpr uint32_t hash(const uint32_t &item) const
     {
         uint32_t x = item;
         uint64_t h = 0;
@@ -189,4 +254,171 @@ private:
     uint32_t modulus;
 };
 
+// Specialisation for 64 bit ints
+template <>
+class TornadoHash<uint64_t>
+{
+public:
+    TornadoHash()
+    {
+        randomize_parameters();
+    }
+
+    // parameters derived from seed instead of the global generator, can be used in constant expressions
+    constexpr explicit TornadoHash(uint64_t seed) : random_bits{}, modulus(1)
+    {
+        for (uint64_t &elem : random_bits)
+        {
+            elem = splitmix64(seed);
+        }
+    }
+
+    constexpr void set_range(uint32_t m)
+    {
+        modulus = m;
+    }
+
+    void randomize_parameters()
+    {
+        std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
+
+        for (uint64_t &elem : random_bits)
+        {
+            elem = dist(gen);
+        }
+    }
+
+    constexpr uint32_t hash(const uint64_t &item) const
+    {
+        uint64_t x = item;
+        uint64_t h = 0;
+        uint8_t c;
+        for (int i = 0; i < 7; ++i)
+        {
+            c = x;
+            x >>= 8;
+            h ^= random_bits[(i << 8) + c];
+        }
+        h ^= x;
+        for (int i = 7; i < 12; ++i)
+        {
+            c = h;
+            h >>= 8;
+            h ^= random_bits[(i << 8) + c];
+        }
+        return ((uint32_t)h) % modulus;
+    }
+
+private:
+    std::array<uint64_t, 12 * 256> random_bits;
+    uint32_t modulus;
+};
+
+// Keys that aren't integers (e.g. std::string) are reduced to 64 bits by std::hash and hashed as uint64_t, keys
+// with the same std::hash value always collide
+template <typename T>
+    requires(!std::is_integral_v<T>)
+class TornadoHash<T>
+{
+public:
+    TornadoHash() = default;
+
+    constexpr explicit TornadoHash(uint64_t seed) : h(seed)
+    {
+    }
+
+    constexpr void set_range(uint32_t m)
+    {
+        h.set_range(m);
+    }
+
+    void randomize_parameters()
+    {
+        h.randomize_parameters();
+    }
+
+    uint32_t hash(const T &item) const
+    {
+        return h.hash(std::hash<T>{}(item));
+    }
+
+private:
+    TornadoHash<uint64_t> h;
+};
+
+// Random permutation of the unsigned integers of type T (a bijection that can be inverted), built from
+// invertible steps: xor-shifts by half the word size, additions and multiplications with odd constants
+template <typename T>
+class PermutationHash
+{
+    // narrower types would be promoted to int, so the multiplications could overflow, and
+    // std::uniform_int_distribution isn't defined for 8 bit types
+    static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>,
+                  "PermutationHash is only defined for uint32_t and uint64_t");
+
+public:
+    PermutationHash()
+    {
+        randomize_parameters();
+    }
+
+    // parameters derived from seed instead of the global generator, can be used in constant expressions
+    constexpr explicit PermutationHash(uint64_t seed)
+        : a(T(splitmix64(seed)) | 1), b(T(splitmix64(seed))), c(T(splitmix64(seed)) | 1),
+          a_inverse(multiplicative_inverse(a)), c_inverse(multiplicative_inverse(c))
+    {
+    }
+
+    void randomize_parameters()
+    {
+        std::uniform_int_distribution<T> dist(0, std::numeric_limits<T>::max());
+        // multipliers have to be odd to be invertible modulo 2^w
+        a = dist(gen) | 1;
+        b = dist(gen);
+        c = dist(gen) | 1;
+        a_inverse = multiplicative_inverse(a);
+        c_inverse = multiplicative_inverse(c);
+    }
+
+    constexpr T hash(const T &item) const
+    {
+        T x = item;
+        x ^= x >> shift;
+        x *= a;
+        x += b;
+        x ^= x >> shift;
+        x *= c;
+        x ^= x >> shift;
+        return x;
+    }
+
+    T invert(const T &value) const
+    {
+        T x = value;
+        x ^= x >> shift;
+        x *= c_inverse;
+        x ^= x >> shift;
+        x -= b;
+        x *= a_inverse;
+        x ^= x >> shift;
+        return x;
+    }
+
+private:
+    // a xor-shift by at least half the word size is its own inverse
+    static constexpr int shift = std::numeric_limits<T>::digits / 2;
+    T a, b, c, a_inverse, c_inverse;
+
+    // inverse of an odd number modulo 2^w using newton iteration (every step doubles the number of correct bits)
+    static constexpr T multiplicative_inverse(T value)
+    {
+        T inverse = value;
+        for (int i = 0; i < 6; ++i)
+        {
+            inverse *= T(2) - value * inverse;
+        }
+        return inverse;
+    }
+};
+
 #endif
\ No newline at end of file
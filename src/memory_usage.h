@@ -0,0 +1,88 @@
+#ifndef memory_usage_
+#define memory_usage_
+
+#include <cstddef>
+#include <cmath>
+
+// Bytes used by a BackyardCuckooHashing and its parts, see BackyardCuckooHashing::memory_usage. All levels have
+// a fixed size, so the numbers only depend on the template parameters. Memory owned by the keys themselves
+// (e.g. the characters of a std::string) isn't included.
+struct MemoryUsage
+{
+    // first level: the stored elements (or remainders), and per bin what is kept next to them (free slot flags,
+    // counters, tags, padding)
+    std::size_t bins_payload = 0;
+    std::size_t bins_metadata = 0;
+    // the elements in the cuckoo tables, and what std::optional adds to every slot (flag and padding) together
+    // with the epoch flags used by the incremental rehash
+    std::size_t cuckoo_tables_payload = 0;
+    std::size_t cuckoo_tables_overhead = 0;
+    // QueueNode arrays of the queue, CdmNodes and position arrays of the cdm
+    std::size_t queue_nodes = 0;
+    std::size_t cdm_nodes = 0;
+    std::size_t cdm_arrays = 0;
+    // all hash functions, a TornadoHash<uint32_t> alone is a table of 16 KiB
+    std::size_t hash_functions = 0;
+    // everything else (sizes, counters, policies, the event trace if compiled in)
+    std::size_t other = 0;
+
+    constexpr MemoryUsage &operator+=(const MemoryUsage &usage)
+    {
+        bins_payload += usage.bins_payload;
+        bins_metadata += usage.bins_metadata;
+        cuckoo_tables_payload += usage.cuckoo_tables_payload;
+        cuckoo_tables_overhead += usage.cuckoo_tables_overhead;
+        queue_nodes += usage.queue_nodes;
+        cdm_nodes += usage.cdm_nodes;
+        cdm_arrays += usage.cdm_arrays;
+        hash_functions += usage.hash_functions;
+        other += usage.other;
+        return *this;
+    }
+
+    constexpr std::size_t total() const
+    {
+        return bins_payload + bins_metadata + cuckoo_tables_payload + cuckoo_tables_overhead + queue_nodes +
+               cdm_nodes + cdm_arrays + hash_functions + other;
+    }
+
+    double bits_per_key(std::size_t num_keys) const
+    {
+        return total() * 8.0 / num_keys;
+    }
+};
+
+// Bytes of an array type used for the storage of a level, including memory it owns outside of the object
+// (CowArray keeps its chunks on the heap)
+template <typename A>
+constexpr std::size_t storage_bytes()
+{
+    if constexpr (requires { A::storage_bytes(); })
+    {
+        return A::storage_bytes();
+    }
+    else
+    {
+        return sizeof(A);
+    }
+}
+
+// Information theoretic lower bound for storing a set of num_keys keys out of a universe of 2^universe_bits
+// keys: log2(binomial(2^universe_bits, num_keys)) bits, divided by the number of keys.
+// log(U! / (U - n)!) is taken from Stirling's series written with log1p, the difference of two lgamma values
+// would cancel almost all digits for a 64 bit universe.
+inline double lower_bound_bits_per_key(int universe_bits, double num_keys)
+{
+    const double universe = std::ldexp(1.0, universe_bits);
+    if (num_keys >= universe)
+    {
+        return 0;
+    }
+    const double rest = universe - num_keys;
+    const double log_falling_factorial = num_keys * std::log(universe) -
+                                         (rest + 0.5) * std::log1p(-num_keys / universe) - num_keys +
+                                         1 / (12 * universe) - 1 / (12 * rest);
+    return (log_falling_factorial - std::lgamma(num_keys + 1)) / std::log(2.0) / num_keys;
+}
+
+#endif
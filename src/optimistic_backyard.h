@@ -0,0 +1,169 @@
+#ifndef optimistic_backyard_
+#define optimistic_backyard_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <optional>
+
+#include "backyard.h"
+#include "seqlock_array.h"
+#include "simple_bin.h"
+
+// Single writer / many readers variant of BackyardCuckooHashing where readers never take a lock.
+// Writes are published through sequence counters (seqlocks): a counter is odd while a write is in progress
+// and readers retry if a counter they depend on was odd or changed during their lookup.
+// - the bins and the cuckoo tables are stored in SeqlockArrays, so every bin and every stripe of cuckoo table
+//   slots has its own counter. An element found in a bin or slot whose counter didn't change was there, so a hit
+//   only depends on the counter of the place where the element was found.
+// - one walk counter covers every write that may move elements or changes the queue (the insert loop moves
+//   elements from the queue into bins and between the cuckoo tables). An evicted element is only held by the
+//   writer until it is placed again, so only a lookup during which no element moved can report a miss. Lookups
+//   that miss, or find the element in the queue, also depend on the walk counter.
+// Hits in bins and cuckoo tables thus only retry if their bin or stripe is written, inserts that run the insert
+// loop make concurrent misses retry.
+// Readers read the data non-atomically and throw away torn results afterwards, which is the usual seqlock
+// protocol (and technically a data race in the C++ memory model).
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
+          int num_elems_cdm, int n_cdm, int k_cdm>
+class OptimisticBackyardCuckooHashing
+{
+public:
+    OptimisticBackyardCuckooHashing(int insert_loop_iterations) : backyard(insert_loop_iterations)
+    {
+    }
+
+    // can be called concurrently with everything
+    bool contains(const T &item) const
+    {
+        while (true)
+        {
+            const uint32_t walk_version = walk_version_counter.load(std::memory_order_acquire);
+            if (in_bin(item) || in_cuckoo_tables(item))
+            {
+                return true;
+            }
+            if (walk_version & 1)
+            {
+                continue;
+            }
+            const bool found = backyard.queue.contains({item, true}) || backyard.queue.contains({item, false});
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (walk_version_counter.load(std::memory_order_relaxed) == walk_version)
+            {
+                return found;
+            }
+        }
+    }
+
+    // insert and remove must only be called by one thread at a time
+    void insert(const T &item)
+    {
+        if (backyard.contains(item))
+        {
+            return;
+        }
+        // an empty queue means the insert loop would only try to put the item into its bin
+        if (backyard.queue.empty() && !backyard.is_rehashing())
+        {
+            const bool inserted = backyard.bins.insert(item);
+            publish();
+            if (inserted)
+            {
+                ++backyard._size;
+                return;
+            }
+        }
+        write_begin(walk_version_counter);
+        backyard.insert(item);
+        publish();
+        write_end(walk_version_counter);
+    }
+
+    bool remove(const T &item)
+    {
+        const bool removed = backyard.bins.remove(item);
+        publish();
+        if (removed)
+        {
+            --backyard._size;
+            return true;
+        }
+        write_begin(walk_version_counter);
+        const bool removed_from_backyard = backyard.remove(item);
+        publish();
+        write_end(walk_version_counter);
+        return removed_from_backyard;
+    }
+
+    int size()
+    {
+        return backyard.size();
+    }
+
+private:
+    BackyardCuckooHashing<T, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm,
+                          SimpleBinCollection<T, num_bins, bin_capacity, 1, SeqlockArray>, SeqlockArray>
+        backyard;
+    // own cache line, so readers don't share it with the data that writers modify
+    alignas(64) std::atomic<uint32_t> walk_version_counter = 0;
+
+    // reads position of array until the read isn't torn
+    template <typename Array, typename F>
+    static bool read_consistent(const Array &array, std::size_t position, F read)
+    {
+        while (true)
+        {
+            const uint32_t version = array.read_begin(position);
+            const bool result = read(array[position]);
+            if (array.read_valid(position, version))
+            {
+                return result;
+            }
+        }
+    }
+
+    bool in_bin(const T &item) const
+    {
+        return read_consistent(backyard.bins.storage(), backyard.bins.bin_index(item), [&item](const auto &bin)
+                               { return bin.contains(item); });
+    }
+
+    // the hash functions may change during the lookup, but an element found in a slot was there
+    bool in_cuckoo_tables(const T &item) const
+    {
+        auto in_slot = [this, &item](int side, uint32_t slot)
+        {
+            return read_consistent(backyard.cuckoo_tables[side], slot, [&item](const std::optional<T> &entry)
+                                   { return entry == item; });
+        };
+        return in_slot(0, backyard.cuckoo_tables_h[0].hash(item)) ||
+               in_slot(1, backyard.cuckoo_tables_h[1].hash(item)) ||
+               (backyard.rehashing && (in_slot(0, backyard.old_cuckoo_tables_h[0].hash(item)) ||
+                                       in_slot(1, backyard.old_cuckoo_tables_h[1].hash(item))));
+    }
+
+    // ends the writes to the bins and cuckoo tables
+    void publish()
+    {
+        backyard.bins.storage().publish();
+        for (int side = 0; side < 2; ++side)
+        {
+            backyard.cuckoo_tables[side].publish();
+            backyard.cuckoo_tables_epoch[side].publish();
+        }
+    }
+
+    static void write_begin(std::atomic<uint32_t> &version)
+    {
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    static void write_end(std::atomic<uint32_t> &version)
+    {
+        version.store(version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+};
+
+#endif
@@ -0,0 +1,314 @@
+#ifndef planner_
+#define planner_
+
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "backyard.h"
+
+// Parameters of a BackyardCuckooHashing chosen by BackyardPlanner, plus the bounds they were chosen for
+struct BackyardPlan
+{
+    int num_bins;
+    int bin_capacity;
+    int size_cuckoo_tables;
+    int n_queue;
+    int k_queue;
+    int num_elems_cdm;
+    int n_cdm;
+    int k_cdm;
+    int insert_loop_iterations;
+    // elements that don't fit into their bin, exceeded with probability at most failure_probability
+    int max_overflow;
+    // elements in the queue and length of an eviction walk that are exceeded with at most that probability
+    int max_queue_length;
+    int max_eviction_walk;
+    // estimate of BackyardCuckooHashing::memory_usage().total() without MemoryUsage::other
+    std::size_t memory_bytes;
+};
+
+// Chooses the parameters of a BackyardCuckooHashing with SimpleBinCollection bins for capacity elements, so that
+// capacity elements fill load_factor of the bin slots and an insert performs at most latency_budget insert loop
+// iterations. Among all bin capacities and cuckoo table loads the plan with the least memory is returned for
+// which the following is exceeded with probability at most failure_probability:
+// - the number of overflowing elements (balls into bins, every bin Poisson distributed and independent,
+//   bounded with a Chernoff bound) fits into the cuckoo tables at the chosen load (below 1/2 per table)
+// - the length of an eviction walk (the cdm throws if it holds more elements), geometric in the model
+// - the queue length, the work in the queue is a random walk that grows by the steps of the new element and
+//   shrinks by latency_budget per insert (Kingman's bound exp(-2 * drift * length / variance)), and has to
+//   hold the elements arriving during the longest eviction walk
+// - a push into the queue or an insert into the cdm that finds all k positions occupied (rebuild)
+// All of it can be evaluated at compile time:
+//   constexpr BackyardPlan plan = BackyardPlanner<uint32_t>::plan(10000, 0.9, 16);
+//   PlannedBackyardCuckooHashing<uint32_t, plan> set(plan.insert_loop_iterations);
+template <typename T>
+class BackyardPlanner
+{
+public:
+    static constexpr BackyardPlan plan(int capacity, double load_factor, int latency_budget,
+                                       double failure_probability = 1e-6)
+    {
+        if (capacity < 1)
+        {
+            throw std::invalid_argument("Backyard Planner: capacity has to be positive");
+        }
+        if (!(load_factor > 0 && load_factor <= 1))
+        {
+            throw std::invalid_argument("Backyard Planner: load factor has to be in (0, 1]");
+        }
+        if (latency_budget < 2)
+        {
+            throw std::invalid_argument("Backyard Planner: the latency budget needs at least two iterations");
+        }
+        if (!(failure_probability > 0 && failure_probability < 1))
+        {
+            throw std::invalid_argument("Backyard Planner: failure probability has to be in (0, 1)");
+        }
+
+        std::optional<BackyardPlan> best;
+        for (std::size_t c = 0; c < bin_capacities.size(); ++c)
+        {
+            const int bin_capacity = bin_capacities[c];
+            const double num_bins = ceil(capacity / (load_factor * bin_capacity));
+            if (num_bins < 1 || num_bins > max_dimension)
+            {
+                continue;
+            }
+            const Overflow overflow = bins_overflow(capacity, int(num_bins), bin_capacity, failure_probability);
+            for (double table_load : table_loads)
+            {
+                const std::optional<BackyardPlan> candidate =
+                    plan_backyard(capacity, int(num_bins), c, overflow, table_load, latency_budget,
+                                  failure_probability);
+                if (candidate.has_value() && (!best.has_value() || candidate->memory_bytes < best->memory_bytes))
+                {
+                    best = candidate;
+                }
+            }
+        }
+        if (!best.has_value())
+        {
+            throw std::invalid_argument("Backyard Planner: no parameters meet the latency budget");
+        }
+        return *best;
+    }
+
+private:
+    using Entry = std::pair<T, bool>;
+
+    static constexpr std::array<int, 11> bin_capacities{1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+    // bytes of one bin for every entry of bin_capacities
+    static constexpr std::array<std::size_t, 11> bin_bytes = []<std::size_t... i>(std::index_sequence<i...>)
+    {
+        return std::array<std::size_t, 11>{sizeof(SimpleBin<T, bin_capacities[i]>)...};
+    }(std::make_index_sequence<11>());
+    // loads of one cuckoo table, two tables stop working at 1/2
+    static constexpr std::array<double, 5> table_loads{0.1, 0.2, 0.3, 0.4, 0.45};
+    // largest array the plan may ask for
+    static constexpr double max_dimension = 1 << 30;
+    static constexpr double ln2 = 0.6931471805599453;
+
+    struct Overflow
+    {
+        double expected;
+        double bound;
+    };
+
+    static constexpr std::optional<BackyardPlan> plan_backyard(int capacity, int num_bins, std::size_t c,
+                                                               const Overflow &overflow, double table_load,
+                                                               int latency_budget, double failure_probability)
+    {
+        const double size_cuckoo_tables = std::max(1.0, ceil(overflow.bound / (2 * table_load)));
+        if (size_cuckoo_tables > max_dimension)
+        {
+            return std::nullopt;
+        }
+        // steps of an element in the insert loop: one if its bin has space, otherwise a walk through the cuckoo
+        // tables that continues with probability about 2 * table_load per step (the edge density of the cuckoo
+        // graph), the number of evictions is geometric
+        const double q = overflow.expected / capacity;
+        const double r = 2 * table_load;
+        const double evictions = r / (1 - r);
+        const double evictions_squared = r * (1 + r) / ((1 - r) * (1 - r));
+        const double mean_steps = 1 + q * evictions;
+        const double variance_steps = q * evictions_squared - q * q * evictions * evictions;
+        const double drift = latency_budget - mean_steps;
+        if (drift <= 0)
+        {
+            return std::nullopt;
+        }
+        const double log_inverse_probability = -log(failure_probability);
+        const double max_eviction_walk = 1 + ceil(log_inverse_probability / -log(r));
+        // every element needs at least one step, so the work bounds the number of elements. While a single walk
+        // of max_eviction_walk steps is in progress, one element arrives per latency_budget steps. The queue
+        // also holds the new element and the one whose walk was interrupted.
+        const double max_queue_length =
+            2 + std::max(ceil(variance_steps * log_inverse_probability / (2 * drift)),
+                         ceil(max_eviction_walk / latency_budget));
+        const std::optional<Dimensions> queue =
+            dimensions(max_queue_length, sizeof(QueueNode<Entry>), failure_probability);
+        const std::optional<Dimensions> cdm = dimensions(max_eviction_walk, sizeof(int), failure_probability);
+        if (!queue.has_value() || !cdm.has_value())
+        {
+            return std::nullopt;
+        }
+
+        const std::size_t memory_bytes =
+            num_bins * bin_bytes[c] +
+            2 * std::size_t(size_cuckoo_tables) * (sizeof(std::optional<T>) + sizeof(bool)) + queue->bytes +
+            std::size_t(max_eviction_walk) * sizeof(CdmNode<Entry>) + cdm->bytes +
+            5 * sizeof(TornadoHash<T>);
+        return BackyardPlan{num_bins,
+                            bin_capacities[c],
+                            int(size_cuckoo_tables),
+                            queue->n,
+                            queue->k,
+                            int(max_eviction_walk),
+                            cdm->n,
+                            cdm->k,
+                            latency_budget,
+                            int(overflow.bound),
+                            int(max_queue_length),
+                            int(max_eviction_walk),
+                            memory_bytes};
+    }
+
+    // Number of elements that don't fit into their bin when capacity elements are thrown into num_bins bins.
+    // The bins are Poisson(capacity / num_bins) and independent, the bound is the smallest
+    // (num_bins * log(E[exp(t * overflow of a bin)]) + log(1 / failure_probability)) / t of a grid of t.
+    static constexpr Overflow bins_overflow(int capacity, int num_bins, int bin_capacity,
+                                            double failure_probability)
+    {
+        const double lambda = double(capacity) / num_bins;
+        // the probabilities of larger loads don't contribute, even weighted with exp(t * load) for t <= 1
+        const int max_load = bin_capacity + int(3 * lambda) + 200;
+        double expected = 0;
+        double bound = capacity;
+        for (int step = 1; step <= 40; ++step)
+        {
+            const double t = step / 40.0;
+            const double growth = exp(t);
+            double probability = exp(-lambda);
+            // exp(t * overflow of the bin)
+            double weight = 1;
+            double moment = 0;
+            for (int load = 0; load <= max_load; ++load)
+            {
+                if (load > 0)
+                {
+                    probability *= lambda / load;
+                }
+                const int excess = std::max(load - bin_capacity, 0);
+                if (excess > 0)
+                {
+                    weight *= growth;
+                }
+                moment += probability * weight;
+                if (step == 1)
+                {
+                    expected += probability * excess;
+                }
+            }
+            bound = std::min(bound, (num_bins * log(moment) - log(failure_probability)) / t);
+        }
+        return {expected * num_bins, ceil(bound)};
+    }
+
+    struct Dimensions
+    {
+        int n;
+        int k;
+        std::size_t bytes;
+    };
+
+    // k arrays of n positions holding up to num_elements elements: an element finds all k of its positions
+    // occupied with probability at most (num_elements / n)^k, k is chosen to need the fewest bytes
+    static constexpr std::optional<Dimensions> dimensions(double num_elements, std::size_t bytes_per_position,
+                                                          double failure_probability)
+    {
+        std::optional<Dimensions> best;
+        for (int k = 1; k <= 32; ++k)
+        {
+            const double n = ceil(num_elements * exp(-log(failure_probability) / k));
+            if (n * k > max_dimension)
+            {
+                continue;
+            }
+            const std::size_t bytes =
+                std::size_t(n) * k * bytes_per_position + k * sizeof(CarterWegmanHash<Entry>);
+            if (!best.has_value() || bytes < best->bytes)
+            {
+                best = Dimensions{int(n), k, bytes};
+            }
+        }
+        return best;
+    }
+
+    // std::exp, std::log and std::ceil aren't constexpr in C++20
+    static constexpr double exp(double x)
+    {
+        if (x < -740)
+        {
+            return 0;
+        }
+        // x = n * ln2 + r with |r| <= ln2 / 2, exp(r) from its Taylor series
+        const int n = int(x / ln2 + (x < 0 ? -0.5 : 0.5));
+        const double r = x - n * ln2;
+        double term = 1;
+        double sum = 1;
+        for (int i = 1; i < 25; ++i)
+        {
+            term *= r / i;
+            sum += term;
+        }
+        for (int i = 0; i < n; ++i)
+        {
+            sum *= 2;
+        }
+        for (int i = 0; i > n; --i)
+        {
+            sum /= 2;
+        }
+        return sum;
+    }
+
+    static constexpr double log(double x)
+    {
+        // x = m * 2^e with 1 <= m < 2, log(m) = 2 * atanh((m - 1) / (m + 1))
+        int e = 0;
+        for (; x >= 2; x /= 2)
+        {
+            ++e;
+        }
+        for (; x < 1; x *= 2)
+        {
+            --e;
+        }
+        const double y = (x - 1) / (x + 1);
+        double power = y;
+        double sum = 0;
+        for (int i = 1; i < 60; i += 2)
+        {
+            sum += power / i;
+            power *= y * y;
+        }
+        return 2 * sum + e * ln2;
+    }
+
+    static constexpr double ceil(double x)
+    {
+        const double truncated = double((long long)x);
+        return truncated < x ? truncated + 1 : truncated;
+    }
+};
+
+template <typename T, BackyardPlan plan>
+using PlannedBackyardCuckooHashing =
+    BackyardCuckooHashing<T, plan.num_bins, plan.bin_capacity, plan.size_cuckoo_tables, plan.n_queue, plan.k_queue,
+                          plan.num_elems_cdm, plan.n_cdm, plan.k_cdm>;
+
+#endif
@@ -4,24 +4,30 @@
 #include <cstddef>
 #include <optional>
 #include <array>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 #include "hash.h"
+#include "memory_usage.h"
+#include "serialization.h"
 
+// prev and next are positions in the arrays of the queue (-1 if there is none) instead of pointers,
+// so a queue can be copied and placed in memory that is mapped at different addresses (e.g. shared memory)
 template <typename T>
 class QueueNode
 {
 public:
     T data;
-    QueueNode<T> *prev;
-    QueueNode<T> *next;
+    int prev;
+    int next;
     bool deleted;
 
-    QueueNode() : data(T{}), prev(nullptr), next(nullptr), deleted(true)
+    QueueNode() : data(T{}), prev(-1), next(-1), deleted(true)
     {
     }
 
-    QueueNode(T data) : data(data), prev(nullptr), next(nullptr), deleted(false)
+    QueueNode(T data) : data(data), prev(-1), next(-1), deleted(false)
     {
     }
 };
@@ -51,16 +57,16 @@ public:
                 arrays[position] = QueueNode<T>(item);
                 ++_size;
 
-                if (tail)
+                if (tail >= 0)
                 {
-                    tail->next = &arrays[position];
+                    arrays[tail].next = position;
                     arrays[position].prev = tail;
-                    tail = &arrays[position];
+                    tail = position;
                     return;
                 }
 
-                head = &arrays[position];
-                tail = &arrays[position];
+                head = position;
+                tail = position;
                 return;
             }
         }
@@ -81,16 +87,16 @@ public:
                 arrays[position] = QueueNode<T>(item);
                 ++_size;
 
-                if (head)
+                if (head >= 0)
                 {
-                    head->prev = &arrays[position];
+                    arrays[head].prev = position;
                     arrays[position].next = head;
-                    head = &arrays[position];
+                    head = position;
                     return;
                 }
 
-                head = &arrays[position];
-                tail = &arrays[position];
+                head = position;
+                tail = position;
                 return;
             }
         }
@@ -106,18 +112,18 @@ public:
             return std::nullopt;
         }
 
-        T item = head->data;
-        head->deleted = true;
+        T item = arrays[head].data;
+        arrays[head].deleted = true;
 
-        if (head->next)
+        if (arrays[head].next >= 0)
         {
-            head = head->next;
-            head->prev = nullptr;
+            head = arrays[head].next;
+            arrays[head].prev = -1;
         }
         else
         {
-            head = nullptr;
-            tail = nullptr;
+            head = -1;
+            tail = -1;
         }
 
         --_size;
@@ -145,24 +151,24 @@ public:
             int position = get_position(i, h[i].hash(item));
             if (!arrays[position].deleted && arrays[position].data == item)
             {
-                QueueNode<T> *node = &arrays[position];
-                node->deleted = true;
+                QueueNode<T> &node = arrays[position];
+                node.deleted = true;
 
-                if (node == head)
+                if (position == head)
                 {
-                    head = node->next;
+                    head = node.next;
                 }
-                if (node == tail)
+                if (position == tail)
                 {
-                    tail = node->prev;
+                    tail = node.prev;
                 }
-                if (node->prev)
+                if (node.prev >= 0)
                 {
-                    node->prev->next = node->next;
+                    arrays[node.prev].next = node.next;
                 }
-                if (node->next)
+                if (node.next >= 0)
                 {
-                    node->next->prev = node->prev;
+                    arrays[node.next].prev = node.prev;
                 }
                 --_size;
                 return true;
@@ -174,7 +180,7 @@ public:
 
     bool empty() const
     {
-        return head == nullptr;
+        return head < 0;
     }
 
     int size() const
@@ -185,28 +191,108 @@ public:
     std::vector<T> to_vector() const
     {
         std::vector<T> items;
-        if (head && !head->deleted)
+        for (int node = head; node >= 0; node = arrays[node].next)
         {
-            QueueNode<T> *node = head;
-            items.push_back(node->data);
-            while (node->next)
+            if (!arrays[node].deleted)
             {
-                node = node->next;
-                if (!node->deleted)
+                items.push_back(arrays[node].data);
+            }
+        }
+        return items;
+    }
+
+    void clear()
+    {
+        for (QueueNode<T> &node : arrays)
+        {
+            node.deleted = true;
+        }
+        head = -1;
+        tail = -1;
+        _size = 0;
+    }
+
+    // number of times the queue sampled new hash functions since it was created
+    int rebuilds() const
+    {
+        return rebuild_count;
+    }
+
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage;
+        usage.queue_nodes = sizeof(arrays);
+        usage.hash_functions = sizeof(h);
+        usage.other = sizeof(ConstantTimeQueue) - sizeof(arrays) - sizeof(h);
+        return usage;
+    }
+
+    // writes the hash functions and the elements in queue order, each with its position in the arrays, so load
+    // restores the queue exactly (without rebuilds) and the arrays don't have to be copied
+    void save(std::ostream &out) const
+    {
+        write_raw(out, h);
+        std::vector<std::pair<int, T>> nodes;
+        for (int node = head; node >= 0; node = arrays[node].next)
+        {
+            nodes.push_back({node, arrays[node].data});
+        }
+        write_items(out, nodes);
+    }
+
+    // throws if a position isn't one of the k positions of its element under the saved hash functions or is
+    // used twice, the queue is only changed if the snapshot is valid
+    void load(std::istream &in)
+    {
+        // copied instead of reading into a new array, constructing hash functions would draw random numbers
+        const std::array<CarterWegmanHash<T>, k> previous_h = h;
+        std::vector<std::pair<int, T>> nodes;
+        try
+        {
+            read_raw(in, h);
+            nodes = read_items<std::pair<int, T>>(in, k * n);
+            std::vector<bool> used(k * n, false);
+            for (const auto &[position, item] : nodes)
+            {
+                if (position < 0 || position >= k * n || used[position] ||
+                    position != get_position(position / n, h[position / n].hash(item)))
                 {
-                    items.push_back(node->data);
+                    throw std::runtime_error("Constant Time Queue: corrupt snapshot, invalid position of an element");
                 }
+                used[position] = true;
             }
         }
-        return items;
+        catch (...)
+        {
+            h = previous_h;
+            throw;
+        }
+
+        clear();
+        for (const auto &[position, item] : nodes)
+        {
+            arrays[position] = QueueNode<T>(item);
+            arrays[position].prev = tail;
+            if (tail >= 0)
+            {
+                arrays[tail].next = position;
+            }
+            else
+            {
+                head = position;
+            }
+            tail = position;
+        }
+        _size = nodes.size();
     }
 
 private:
     std::array<QueueNode<T>, k * n> arrays;
     std::array<CarterWegmanHash<T>, k> h;
-    QueueNode<T> *head = nullptr;
-    QueueNode<T> *tail = nullptr;
+    int head = -1;
+    int tail = -1;
     int _size;
+    int rebuild_count = 0;
 
     int get_position(int num_array, int array_index) const
     {
@@ -215,23 +301,17 @@ private:
 
     void rebuild(const T &item, bool place_at_front)
     {
+        ++rebuild_count;
         std::vector<T> items;
         if (place_at_front)
         {
             items.push_back(item);
         }
         // collect all present elements in the data structure and set them as deleted
-        if (head)
+        for (int node = head; node >= 0; node = arrays[node].next)
         {
-            QueueNode<T> *node = head;
-            node->deleted = true;
-            items.push_back(node->data);
-            while (node->next)
-            {
-                node = node->next;
-                node->deleted = true;
-                items.push_back(node->data);
-            }
+            arrays[node].deleted = true;
+            items.push_back(arrays[node].data);
         }
         if (!place_at_front)
         {
@@ -242,8 +322,8 @@ private:
         {
             h[i].randomize_parameters();
         }
-        head = nullptr;
-        tail = nullptr;
+        head = -1;
+        tail = -1;
         _size = 0;
 
         // insert all elements into the data structure again (with new seed), this may call rebuild again
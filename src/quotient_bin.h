@@ -0,0 +1,235 @@
+#ifndef quotient_bin_
+#define quotient_bin_
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <limits>
+#include <type_traits>
+#include "hash.h"
+#include "memory_usage.h"
+
+// Smallest unsigned integer type with at least num_bits bits
+template <int num_bits>
+using OccupancyMask = std::conditional_t<num_bits <= 8, uint8_t,
+                                         std::conditional_t<num_bits <= 16, uint16_t,
+                                                            std::conditional_t<num_bits <= 32, uint32_t, uint64_t>>>;
+
+// First level that only stores the remainders of the elements (quotienting). Every element is mapped to
+// p = pi(x) with a random permutation pi, then q = p % num_bins is the bin index (quotient) and
+// r = p / num_bins is stored in the bin. Since pi is a bijection, (q, r) identifies x, so a remainder needs
+// log2(2^w / num_bins) instead of w bits.
+// The remainders of a bin are packed into 64 bit words with as many fields as fit into a word, so a lookup
+// compares all fields of a word at once (SIMD within a register). Remainders of more than 32 bits are packed
+// tightly across word boundaries instead, since only one of them would fit into a word anyway.
+template <typename T, int num_bins, int bin_capacity>
+class QuotientBinCollection
+{
+    static_assert(std::is_unsigned_v<T>, "QuotientBinCollection is only defined for unsigned integers");
+    static_assert(bin_capacity >= 1 && bin_capacity <= 64, "QuotientBinCollection supports bins with up to 64 slots");
+
+public:
+    static constexpr int remainder_bits = std::bit_width(std::numeric_limits<T>::max() / num_bins);
+    static constexpr int fields_per_word = 64 / remainder_bits;
+    static constexpr bool packed_across_words = fields_per_word == 1 && remainder_bits < 64;
+    static constexpr int words_per_bin = packed_across_words
+                                             ? (bin_capacity * remainder_bits + 63) / 64
+                                             : (bin_capacity + fields_per_word - 1) / fields_per_word;
+
+    static_assert(remainder_bits >= 1, "QuotientBinCollection: more bins than distinct elements");
+
+    QuotientBinCollection()
+    {
+        for (std::array<uint64_t, words_per_bin> &bin : remainders)
+        {
+            bin.fill(0);
+        }
+        occupied.fill(0);
+        _size = 0;
+    }
+
+    bool insert(const T &item)
+    {
+        const int q = quotient(item);
+        if (std::popcount(occupied[q]) >= bin_capacity)
+        {
+            return false;
+        }
+        const int slot = std::countr_one(occupied[q]);
+        set_field(q, slot, remainder(item));
+        occupied[q] |= Occupancy(1) << slot;
+        ++_size;
+        return true;
+    }
+
+    bool remove(const T &item)
+    {
+        const int q = quotient(item);
+        const int slot = find(q, remainder(item));
+        if (slot < 0)
+        {
+            return false;
+        }
+        set_field(q, slot, 0);
+        occupied[q] &= ~(Occupancy(1) << slot);
+        --_size;
+        return true;
+    }
+
+    bool contains(const T &item) const
+    {
+        return find(quotient(item), remainder(item)) >= 0;
+    }
+
+    int size() const
+    {
+        return _size;
+    }
+
+    // calls f for every element
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (int q = 0; q < num_bins; ++q)
+        {
+            for (Occupancy slots = occupied[q]; slots; slots &= slots - 1)
+            {
+                f(element(q, get_field(q, std::countr_zero(slots))));
+            }
+        }
+    }
+
+    // reconstructs the element stored with remainder r in bin q
+    T element(int q, uint64_t r) const
+    {
+        return h.invert(T(r) * T(num_bins) + T(q));
+    }
+
+    // memory used by the bins (remainders and occupancy), without the hash function
+    static constexpr std::size_t size_in_bits()
+    {
+        return (sizeof(std::array<std::array<uint64_t, words_per_bin>, num_bins>) +
+                sizeof(std::array<Occupancy, num_bins>)) *
+               8;
+    }
+
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage;
+        usage.bins_payload = sizeof(remainders);
+        usage.bins_metadata = sizeof(occupied);
+        usage.hash_functions = sizeof(h);
+        usage.other = sizeof(QuotientBinCollection) - sizeof(remainders) - sizeof(occupied) - sizeof(h);
+        return usage;
+    }
+
+private:
+    using Occupancy = OccupancyMask<bin_capacity>;
+
+    static constexpr uint64_t field_mask = remainder_bits == 64 ? ~uint64_t(0) : (uint64_t(1) << remainder_bits) - 1;
+
+    // lowest bit of every field in a word
+    static constexpr uint64_t low_bits = []()
+    {
+        uint64_t bits = 0;
+        for (int i = 0; i < fields_per_word; ++i)
+        {
+            bits |= uint64_t(1) << (i * remainder_bits);
+        }
+        return bits;
+    }();
+    // highest bit of every field in a word
+    static constexpr uint64_t high_bits = low_bits << (remainder_bits - 1);
+    // all bits of the fields except the highest ones
+    static constexpr uint64_t rest_bits = (low_bits * field_mask) & ~high_bits;
+
+    std::array<std::array<uint64_t, words_per_bin>, num_bins> remainders;
+    std::array<Occupancy, num_bins> occupied;
+    PermutationHash<T> h;
+    int _size;
+
+    int quotient(const T &item) const
+    {
+        return h.hash(item) % num_bins;
+    }
+
+    uint64_t remainder(const T &item) const
+    {
+        return h.hash(item) / num_bins;
+    }
+
+    void set_field(int q, int slot, uint64_t value)
+    {
+        if constexpr (packed_across_words)
+        {
+            const int bit = slot * remainder_bits;
+            const int offset = bit % 64;
+            uint64_t &word = remainders[q][bit / 64];
+            word = (word & ~(field_mask << offset)) | (value << offset);
+            if (offset + remainder_bits > 64)
+            {
+                uint64_t &next_word = remainders[q][bit / 64 + 1];
+                next_word = (next_word & ~(field_mask >> (64 - offset))) | (value >> (64 - offset));
+            }
+            return;
+        }
+        uint64_t &word = remainders[q][slot / fields_per_word];
+        const int offset = (slot % fields_per_word) * remainder_bits;
+        word = (word & ~(field_mask << offset)) | (value << offset);
+    }
+
+    uint64_t get_field(int q, int slot) const
+    {
+        if constexpr (!packed_across_words)
+        {
+            return (remainders[q][slot / fields_per_word] >> ((slot % fields_per_word) * remainder_bits)) & field_mask;
+        }
+        const int bit = slot * remainder_bits;
+        const int offset = bit % 64;
+        uint64_t value = remainders[q][bit / 64] >> offset;
+        if (offset + remainder_bits > 64)
+        {
+            value |= remainders[q][bit / 64 + 1] << (64 - offset);
+        }
+        return value & field_mask;
+    }
+
+    // returns the slot holding the remainder r in bin q or -1
+    int find(int q, uint64_t r) const
+    {
+        if constexpr (packed_across_words)
+        {
+            for (Occupancy slots = occupied[q]; slots; slots &= slots - 1)
+            {
+                const int slot = std::countr_zero(slots);
+                if (get_field(q, slot) == r)
+                {
+                    return slot;
+                }
+            }
+            return -1;
+        }
+        // copy r into every field, fields equal to r become zero after the xor
+        const uint64_t pattern = low_bits * r;
+        for (int w = 0; w < words_per_bin; ++w)
+        {
+            const uint64_t x = remainders[q][w] ^ pattern;
+            // sets the highest bit of exactly the fields that are zero (the addition can't carry into the next field)
+            uint64_t zero_fields = ~(((x & rest_bits) + rest_bits) | x | rest_bits) & high_bits;
+            // empty slots are zero as well, so matches still have to be checked against the occupancy
+            while (zero_fields)
+            {
+                const int slot = w * fields_per_word + std::countr_zero(zero_fields) / remainder_bits;
+                if (slot < bin_capacity && (occupied[q] >> slot) & 1)
+                {
+                    return slot;
+                }
+                zero_fields &= zero_fields - 1;
+            }
+        }
+        return -1;
+    }
+};
+
+#endif
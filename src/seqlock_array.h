@@ -0,0 +1,97 @@
+#ifndef seqlock_array_
+#define seqlock_array_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <vector>
+
+// Fixed size array (same interface as the parts of std::array the data structures use) for one writer and
+// readers that don't take a lock. Every stripe of elements that share a cache line has a sequence counter which
+// is odd while the stripe is written (seqlock).
+// Non-const element access counts as a write: it makes the counter of the stripe odd until the writer calls
+// publish(), so the writer can change a stripe in several steps. Readers get the counter with read_begin, read
+// the element through a const reference and retry if read_valid returns false.
+template <typename T, std::size_t N>
+class SeqlockArray
+{
+public:
+    // a power of two, so positions are split into stripe and offset with shifts
+    static constexpr std::size_t stripe_size = std::bit_floor(std::max<std::size_t>(64 / sizeof(T), 1));
+    static constexpr std::size_t num_stripes = (N + stripe_size - 1) / stripe_size;
+
+    const T &operator[](std::size_t position) const
+    {
+        return elements[position];
+    }
+
+    T &operator[](std::size_t position)
+    {
+        const std::size_t stripe = position / stripe_size;
+        const uint32_t version = versions[stripe].load(std::memory_order_relaxed);
+        // the stripe may already be written since the last publish
+        if (!(version & 1))
+        {
+            versions[stripe].store(version + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            written_stripes.push_back(stripe);
+        }
+        return elements[position];
+    }
+
+    void fill(const T &value)
+    {
+        for (std::size_t stripe = 0; stripe < num_stripes; ++stripe)
+        {
+            (*this)[stripe * stripe_size];
+        }
+        elements.fill(value);
+        publish();
+    }
+
+    static constexpr std::size_t size()
+    {
+        return N;
+    }
+
+    // makes all writes since the last call visible, readers of the written stripes retry until then
+    void publish()
+    {
+        for (std::size_t stripe : written_stripes)
+        {
+            versions[stripe].store(versions[stripe].load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+        written_stripes.clear();
+    }
+
+    // counter of the stripe of position, waits while the stripe is written
+    uint32_t read_begin(std::size_t position) const
+    {
+        while (true)
+        {
+            const uint32_t version = versions[position / stripe_size].load(std::memory_order_acquire);
+            if (!(version & 1))
+            {
+                return version;
+            }
+        }
+    }
+
+    // true if the stripe of position wasn't written since read_begin returned version
+    bool read_valid(std::size_t position, uint32_t version) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return versions[position / stripe_size].load(std::memory_order_relaxed) == version;
+    }
+
+private:
+    alignas(64) std::array<T, N> elements;
+    std::array<std::atomic<uint32_t>, num_stripes> versions{};
+    // stripes whose counter is odd, only accessed by the writer
+    std::vector<std::size_t> written_stripes;
+};
+
+#endif
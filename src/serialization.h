@@ -0,0 +1,112 @@
+#ifndef serialization_
+#define serialization_
+
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Helpers for the binary snapshot format. Values are written with their in-memory representation, so a snapshot
+// can only be loaded on a machine with the same endianness and type sizes.
+
+template <typename T>
+void write_raw(std::ostream &out, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "write_raw: type can't be copied byte by byte");
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void read_raw(std::istream &in, T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "read_raw: type can't be copied byte by byte");
+    if (!in.read(reinterpret_cast<char *>(&value), sizeof(T)))
+    {
+        throw std::runtime_error("Serialization: unexpected end of snapshot");
+    }
+}
+
+// std::pair isn't trivially copyable (it has its own assignment operator), its members are written one by one
+template <typename A, typename B>
+void write_raw(std::ostream &out, const std::pair<A, B> &value)
+{
+    write_raw(out, value.first);
+    write_raw(out, value.second);
+}
+
+template <typename A, typename B>
+void read_raw(std::istream &in, std::pair<A, B> &value)
+{
+    read_raw(in, value.first);
+    read_raw(in, value.second);
+}
+
+// number of items followed by the items
+template <typename T>
+void write_items(std::ostream &out, const std::vector<T> &items)
+{
+    write_raw(out, (uint64_t)items.size());
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        out.write(reinterpret_cast<const char *>(items.data()), items.size() * sizeof(T));
+    }
+    else
+    {
+        for (const T &item : items)
+        {
+            write_raw(out, item);
+        }
+    }
+}
+
+// bytes between the read position and the end of in, the maximum if in can't seek
+inline uint64_t remaining_bytes(std::istream &in)
+{
+    const std::streampos position = in.tellg();
+    if (position == std::streampos(-1) || !in.seekg(0, std::ios::end))
+    {
+        in.clear();
+        return std::numeric_limits<uint64_t>::max();
+    }
+    const std::streampos end = in.tellg();
+    in.seekg(position);
+    return end == std::streampos(-1) ? std::numeric_limits<uint64_t>::max() : uint64_t(end - position);
+}
+
+// throws before allocating if the snapshot claims more than max_items items or more than the rest of the
+// snapshot can hold (every item takes at least one byte, trivially copyable ones sizeof(T))
+template <typename T>
+std::vector<T> read_items(std::istream &in, uint64_t max_items = std::numeric_limits<uint64_t>::max())
+{
+    uint64_t num_items;
+    read_raw(in, num_items);
+    const uint64_t item_bytes = std::is_trivially_copyable_v<T> ? sizeof(T) : 1;
+    if (num_items > max_items || num_items > remaining_bytes(in) / item_bytes)
+    {
+        throw std::runtime_error("Serialization: snapshot claims more items than it can hold");
+    }
+    std::vector<T> items(num_items);
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        if (!in.read(reinterpret_cast<char *>(items.data()), num_items * sizeof(T)))
+        {
+            throw std::runtime_error("Serialization: unexpected end of snapshot");
+        }
+    }
+    else
+    {
+        for (T &item : items)
+        {
+            read_raw(in, item);
+        }
+    }
+    return items;
+}
+
+#endif
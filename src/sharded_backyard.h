@@ -0,0 +1,402 @@
+#ifndef sharded_backyard_
+#define sharded_backyard_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "hash.h"
+
+// Bounded lock-free queue for many producers and one consumer (ring buffer with a sequence number per cell)
+template <typename T, int capacity>
+class MpscRing
+{
+    static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "MpscRing: capacity has to be a power of two");
+
+public:
+    MpscRing()
+    {
+        for (int i = 0; i < capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool try_push(const T &item)
+    {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[position & (capacity - 1)];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (sequence == position)
+            {
+                // the cell is free, claim it
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.data = item;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (sequence < position)
+            {
+                // the consumer didn't free the cell yet, the ring is full
+                return false;
+            }
+            else
+            {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // must only be called by the consumer
+    bool try_pop(T &item)
+    {
+        Cell &cell = cells[head & (capacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            return false;
+        }
+        item = cell.data;
+        cell.sequence.store(head + capacity, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    std::array<Cell, capacity> cells;
+    alignas(64) std::atomic<std::size_t> tail = 0;
+    alignas(64) std::size_t head = 0;
+};
+
+enum class OperationType : uint8_t
+{
+    insert,
+    remove,
+    contains
+};
+
+// result is set for remove (element was present) and contains
+template <typename T>
+struct Operation
+{
+    OperationType type;
+    T key;
+    bool result;
+};
+
+// Share-nothing front end: keys are partitioned by the high bits of a hash into num_shards independent
+// instances of Shard (e.g. BackyardCuckooHashing). Every shard is created and only ever accessed by its own
+// worker thread, which is pinned to a core, so its bins, cuckoo tables, queue and cdm stay in that core's cache
+// and need no synchronization. Other threads submit batches of operations through one lock-free ring per shard
+// and wait until all shards processed their part. Operations on the same key are applied in batch order.
+// Shard i draws its hash functions from a generator seeded with (seed, i), so runs are reproducible no matter in
+// which order the workers start. Idle workers and waiting clients block instead of spinning.
+// An exception thrown by a Shard is passed on to the caller: by the constructor if a shard can't be created, by
+// execute if an operation throws. The remaining operations of that shard in the batch are skipped then.
+template <typename T, int num_shards, typename Shard, int ring_capacity = 1024>
+class ShardedBackyard
+{
+    static_assert(std::numeric_limits<T>::digits >= 32, "ShardedBackyard: keys need at least 32 bits");
+
+public:
+    // shard i runs on cpus[i % cpus.size()], no pinning if cpus is empty
+    ShardedBackyard(int insert_loop_iterations, std::vector<int> cpus = default_cpus(), uint64_t seed = 42)
+        : h(seed)
+    {
+        for (int i = 0; i < num_shards; ++i)
+        {
+            const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+            workers[i] = std::thread(&ShardedBackyard::run_worker, this, i, insert_loop_iterations, cpu, seed);
+        }
+        // wait until every worker allocated its shard or failed to
+        for (int ready = num_ready.load(std::memory_order_acquire); ready < num_shards;
+             ready = num_ready.load(std::memory_order_acquire))
+        {
+            num_ready.wait(ready, std::memory_order_acquire);
+        }
+        for (std::exception_ptr &error : construction_errors)
+        {
+            if (error)
+            {
+                // the destructor doesn't run for a constructor that throws
+                stop_workers();
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    ~ShardedBackyard()
+    {
+        stop_workers();
+    }
+
+    ShardedBackyard(const ShardedBackyard &) = delete;
+    ShardedBackyard &operator=(const ShardedBackyard &) = delete;
+
+    // applies all operations and fills in their results, can be called by many threads concurrently
+    void execute(std::span<Operation<T>> batch)
+    {
+        // positions of the operations of every shard, in batch order
+        std::array<std::vector<Operation<T> *>, num_shards> per_shard;
+        for (Operation<T> &operation : batch)
+        {
+            per_shard[shard_index(operation.key)].push_back(&operation);
+        }
+
+        Completion completion;
+        for (int i = 0; i < num_shards; ++i)
+        {
+            if (!per_shard[i].empty())
+            {
+                ++completion.pending;
+            }
+        }
+        for (int i = 0; i < num_shards; ++i)
+        {
+            if (per_shard[i].empty())
+            {
+                continue;
+            }
+            const Message message{per_shard[i].data(), (int)per_shard[i].size(), &completion};
+            while (!rings[i].try_push(message))
+            {
+                std::this_thread::yield();
+            }
+            wake_worker(i);
+        }
+        {
+            // the workers only touch completion while they hold its lock, so it can be destroyed afterwards
+            std::unique_lock<std::mutex> lock(completion.mutex);
+            completion.done.wait(lock, [&completion]()
+                                 { return completion.pending == 0; });
+        }
+        if (completion.error)
+        {
+            std::rethrow_exception(completion.error);
+        }
+    }
+
+    void insert(const T &item)
+    {
+        Operation<T> operation{OperationType::insert, item, false};
+        execute({&operation, 1});
+    }
+
+    bool remove(const T &item)
+    {
+        Operation<T> operation{OperationType::remove, item, false};
+        execute({&operation, 1});
+        return operation.result;
+    }
+
+    bool contains(const T &item)
+    {
+        Operation<T> operation{OperationType::contains, item, false};
+        execute({&operation, 1});
+        return operation.result;
+    }
+
+    int shard_index(const T &item) const
+    {
+        // the upper 32 bits of the hash value scaled to [0, num_shards)
+        const uint64_t high_bits = uint64_t(h.hash(item) >> (std::numeric_limits<T>::digits - 32));
+        return (high_bits * num_shards) >> 32;
+    }
+
+    // number of workers that couldn't be pinned to their cpu, always num_shards if pinning isn't supported
+    int pinning_failures() const
+    {
+        return num_pinning_failures.load(std::memory_order_relaxed);
+    }
+
+private:
+    // shared by the shards of one call of execute
+    struct Completion
+    {
+        std::mutex mutex;
+        std::condition_variable done;
+        // guarded by mutex
+        int pending = 0;
+        std::exception_ptr error;
+    };
+
+    struct Message
+    {
+        Operation<T> **operations;
+        int num_operations;
+        Completion *completion;
+    };
+
+    // times a worker tries to pop from its empty ring before it blocks
+    static constexpr int idle_spins = 64;
+
+    PermutationHash<T> h;
+    std::array<MpscRing<Message, ring_capacity>, num_shards> rings;
+    // bumped after every push to a ring, idle workers block until it changes
+    std::array<std::atomic<uint32_t>, num_shards> ring_signals{};
+    std::array<std::thread, num_shards> workers;
+    std::array<std::exception_ptr, num_shards> construction_errors;
+    std::atomic<int> num_ready = 0;
+    std::atomic<int> num_pinning_failures = 0;
+    std::atomic<bool> stop = false;
+
+    static std::vector<int> default_cpus()
+    {
+        std::vector<int> cpus(std::max(1u, std::thread::hardware_concurrency()));
+        for (std::size_t i = 0; i < cpus.size(); ++i)
+        {
+            cpus[i] = i;
+        }
+        return cpus;
+    }
+
+    // pins the calling thread to a cpu, returns false if that failed (only supported on linux)
+    static bool pin_to_cpu(int cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(cpu, &cpu_set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+        (void)cpu;
+        return false;
+#endif
+    }
+
+    void wake_worker(int index)
+    {
+        ring_signals[index].fetch_add(1);
+        ring_signals[index].notify_one();
+    }
+
+    void stop_workers()
+    {
+        stop.store(true);
+        for (int i = 0; i < num_shards; ++i)
+        {
+            wake_worker(i);
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // pops the next message, blocks while the ring is empty, returns false once the set is destroyed
+    bool next_message(int index, Message &message)
+    {
+        for (int spins = 0;; ++spins)
+        {
+            // read before the ring, so a push after the failed pop changes it and the wait returns
+            const uint32_t signal = ring_signals[index].load();
+            if (rings[index].try_pop(message))
+            {
+                return true;
+            }
+            if (stop.load())
+            {
+                return false;
+            }
+            if (spins < idle_spins)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                ring_signals[index].wait(signal);
+            }
+        }
+    }
+
+    void run_worker(int index, int insert_loop_iterations, int cpu, uint64_t seed)
+    {
+        if (cpu >= 0 && !pin_to_cpu(cpu))
+        {
+            num_pinning_failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        // the generator of this thread only depends on the seed and the shard
+        uint64_t state = seed + index + 1;
+        gen.seed(splitmix64(state));
+        // allocated after pinning, so its memory is local to the worker's core
+        std::unique_ptr<Shard> shard;
+        try
+        {
+            shard = std::make_unique<Shard>(insert_loop_iterations);
+        }
+        catch (...)
+        {
+            construction_errors[index] = std::current_exception();
+        }
+        num_ready.fetch_add(1, std::memory_order_release);
+        num_ready.notify_all();
+        if (!shard)
+        {
+            return;
+        }
+
+        Message message;
+        while (next_message(index, message))
+        {
+            std::exception_ptr error;
+            try
+            {
+                for (int i = 0; i < message.num_operations; ++i)
+                {
+                    Operation<T> &operation = *message.operations[i];
+                    switch (operation.type)
+                    {
+                    case OperationType::insert:
+                        shard->insert(operation.key);
+                        break;
+                    case OperationType::remove:
+                        operation.result = shard->remove(operation.key);
+                        break;
+                    case OperationType::contains:
+                        operation.result = shard->contains(operation.key);
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            Completion &completion = *message.completion;
+            std::lock_guard<std::mutex> lock(completion.mutex);
+            if (error && !completion.error)
+            {
+                completion.error = error;
+            }
+            if (--completion.pending == 0)
+            {
+                completion.done.notify_one();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef shared_backyard_
+#define shared_backyard_
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "optimistic_backyard.h"
+
+// OptimisticBackyardCuckooHashing placed in a POSIX shared memory segment: one writer process creates the
+// segment and modifies the set, any number of reader processes attach to it and look elements up concurrently
+// without locks (see optimistic_backyard.h). Bins, cuckoo tables, queue and cdm only link by array positions,
+// so the set is valid at whatever address a process maps the segment.
+// All processes have to run the same build, the segment stores the set in its in-memory representation.
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables, int n_queue, int k_queue,
+          int num_elems_cdm, int n_cdm, int k_cdm>
+class SharedBackyard
+{
+    using Set = OptimisticBackyardCuckooHashing<T, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue,
+                                                num_elems_cdm, n_cdm, k_cdm>;
+
+public:
+    // Writer: creates the segment (fails if it exists) and the set in it. name has to start with a slash.
+    // The segment is removed when the writer is destroyed, attached readers keep their mapping.
+    SharedBackyard(const std::string &name, int insert_loop_iterations) : name(name), is_writer(true)
+    {
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Shared Backyard: can't create segment " + name);
+        }
+        if (ftruncate(fd, segment_size) != 0)
+        {
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::runtime_error("Shared Backyard: can't resize segment " + name);
+        }
+        map(fd, PROT_READ | PROT_WRITE);
+
+        Header *header = new (mapping) Header;
+        header->magic = magic;
+        header->version = version;
+        header->set_size = sizeof(Set);
+        set = new (static_cast<std::byte *>(mapping) + set_offset) Set(insert_loop_iterations);
+        // readers may only use the set once it is constructed
+        header->ready.store(1, std::memory_order_release);
+    }
+
+    // Reader: attaches to the segment of a writer
+    explicit SharedBackyard(const std::string &name) : name(name), is_writer(false)
+    {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Shared Backyard: can't open segment " + name);
+        }
+        struct stat segment_stat;
+        if (fstat(fd, &segment_stat) != 0 || (std::size_t)segment_stat.st_size != segment_size)
+        {
+            close(fd);
+            throw std::runtime_error("Shared Backyard: segment " + name + " has the wrong size");
+        }
+        map(fd, PROT_READ);
+
+        const Header *header = static_cast<const Header *>(mapping);
+        if (header->magic != magic || header->version != version || header->set_size != sizeof(Set) ||
+            !header->ready.load(std::memory_order_acquire))
+        {
+            munmap(mapping, segment_size);
+            throw std::runtime_error("Shared Backyard: segment " + name + " holds no set of this configuration");
+        }
+        set = reinterpret_cast<Set *>(static_cast<std::byte *>(mapping) + set_offset);
+    }
+
+    ~SharedBackyard()
+    {
+        if (is_writer)
+        {
+            set->~Set();
+            shm_unlink(name.c_str());
+        }
+        munmap(mapping, segment_size);
+    }
+
+    SharedBackyard(const SharedBackyard &) = delete;
+    SharedBackyard &operator=(const SharedBackyard &) = delete;
+
+    bool contains(const T &item) const
+    {
+        return set->contains(item);
+    }
+
+    // only the writer can modify the set
+    void insert(const T &item)
+    {
+        check_writer();
+        set->insert(item);
+    }
+
+    bool remove(const T &item)
+    {
+        check_writer();
+        return set->remove(item);
+    }
+
+    int size()
+    {
+        check_writer();
+        return set->size();
+    }
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t set_size;
+        std::atomic<uint32_t> ready = 0;
+    };
+
+    // "BYSM" in little endian, the version has to be increased whenever the layout of the set changes
+    static constexpr uint32_t magic = 0x4d535942;
+    static constexpr uint32_t version = 1;
+    static constexpr std::size_t set_offset = (sizeof(Header) + alignof(Set) - 1) / alignof(Set) * alignof(Set);
+    static constexpr std::size_t segment_size = set_offset + sizeof(Set);
+
+    std::string name;
+    bool is_writer;
+    void *mapping;
+    Set *set;
+
+    void map(int fd, int protection)
+    {
+        mapping = mmap(nullptr, segment_size, protection, MAP_SHARED, fd, 0);
+        // the mapping stays valid after closing the segment
+        close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            if (is_writer)
+            {
+                shm_unlink(name.c_str());
+            }
+            throw std::runtime_error("Shared Backyard: can't map segment " + name);
+        }
+    }
+
+    void check_writer() const
+    {
+        if (!is_writer)
+        {
+            throw std::runtime_error("Shared Backyard: only the writer can modify the set");
+        }
+    }
+};
+
+#endif
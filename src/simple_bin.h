@@ -2,21 +2,27 @@
 #define simple_bin_
 
 #include <cstddef>
+#include <algorithm>
 #include <array>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "hash.h"
+#include "memory_usage.h"
 
 template <typename T, int capacity>
 class SimpleBin
 {
 public:
-    SimpleBin()
+    constexpr SimpleBin()
     {
         elems.fill(T{});
         deleted.fill(true);
         num_elems = 0;
     }
 
-    bool insert(const T &item)
+    constexpr bool insert(const T &item)
     {
         for (int i = 0; i < capacity; ++i)
         {
@@ -31,7 +37,7 @@ public:
         return false;
     }
 
-    bool remove(const T &item)
+    constexpr bool remove(const T &item)
     {
         for (int i = 0; i < capacity; ++i)
         {
@@ -45,7 +51,7 @@ public:
         return false;
     }
 
-    bool contains(const T &item) const
+    constexpr bool contains(const T &item) const
     {
         for (int i = 0; i < capacity; ++i)
         {
@@ -57,39 +63,70 @@ public:
         return false;
     }
 
-    int size() const
+    constexpr int size() const
     {
         return num_elems;
     }
 
-    bool has_space() const
+    constexpr bool has_space() const
     {
         return num_elems < capacity;
     }
 
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (int i = 0; i < capacity; ++i)
+        {
+            if (!deleted[i])
+            {
+                f(elems[i]);
+            }
+        }
+    }
+
 private:
     std::array<T, capacity> elems;
     std::array<bool, capacity> deleted;
     int num_elems;
 };
 
-template <typename T, int num_bins, int bin_capacity>
+// num_choices = 1 maps every element to exactly one bin, num_choices = 2 uses two candidate bins
+// (power of two choices) and places an element into the less loaded one.
+// Array stores the bins, e.g. CowArray (see cow_array.h) to share them with snapshots.
+template <typename T, int num_bins, int bin_capacity, int num_choices = 1,
+          template <typename, std::size_t> typename Array = std::array>
 class SimpleBinCollection
 {
+    static_assert(num_choices == 1 || num_choices == 2, "SimpleBinCollection supports one or two choices");
+
 public:
     SimpleBinCollection()
     {
         bins.fill(SimpleBin<T, bin_capacity>{});
-        h.set_range(num_bins);
+        for (int i = 0; i < num_choices; ++i)
+        {
+            h[i].set_range(num_bins);
+        }
         _size = 0;
     }
 
+    // bins are only accessed through a const reference until one of them changes, so copy-on-write storage
+    // isn't copied for full bins or elements that aren't there
     bool insert(const T &item)
     {
-        SimpleBin<T, bin_capacity> &bin = bins[h.hash(item)];
-        if (bin.has_space())
+        int bin = h[0].hash(item);
+        if constexpr (num_choices == 2)
+        {
+            const int other = h[1].hash(item);
+            if (std::as_const(bins)[other].size() < std::as_const(bins)[bin].size())
+            {
+                bin = other;
+            }
+        }
+        if (std::as_const(bins)[bin].has_space())
         {
-            bin.insert(item);
+            bins[bin].insert(item);
             ++_size;
             return true;
         }
@@ -98,17 +135,29 @@ public:
 
     bool remove(const T &item)
     {
-        if (bins[h.hash(item)].remove(item))
+        for (int i = 0; i < num_choices; ++i)
         {
-            _size--;
-            return true;
+            const int bin = h[i].hash(item);
+            if (std::as_const(bins)[bin].contains(item))
+            {
+                bins[bin].remove(item);
+                _size--;
+                return true;
+            }
         }
         return false;
     }
 
     bool contains(const T &item) const
     {
-        return bins[h.hash(item)].contains(item);
+        if constexpr (num_choices == 2)
+        {
+            // fetch the second bin while the first one is searched
+            const SimpleBin<T, bin_capacity> &other = bins[h[1].hash(item)];
+            __builtin_prefetch(&other);
+            return bins[h[0].hash(item)].contains(item) || other.contains(item);
+        }
+        return bins[h[0].hash(item)].contains(item);
     }
 
     int size() const
@@ -116,10 +165,181 @@ public:
         return _size;
     }
 
+    // Inserts all keys that aren't present yet and returns those that didn't fit into their bin (duplicates
+    // included). The keys are radix partitioned by bin index into groups of consecutive bins, then every thread
+    // fills the bins of its groups, so no two threads touch the same bin. Within a bin the keys are inserted in
+    // input order, so the bins end up as after inserting the keys one by one.
+    // Two-choice bins are filled sequentially, the bin of an element depends on the load of both candidates.
+    std::vector<T> bulk_insert(std::span<const T> keys, int num_threads)
+    {
+        std::vector<T> overflow;
+        if (num_choices == 2 || num_threads <= 1)
+        {
+            for (const T &key : keys)
+            {
+                if (!contains(key) && !insert(key))
+                {
+                    overflow.push_back(key);
+                }
+            }
+            return overflow;
+        }
+
+        const std::size_t n = keys.size();
+        // a few groups per thread, so threads with many overflowing keys don't hold up the others
+        const int num_groups = std::min(num_bins, 8 * num_threads);
+        auto group_of = [num_groups](int bin)
+        { return int((long long)bin * num_groups / num_bins); };
+        auto chunk_begin = [n, num_threads](int t)
+        { return n * t / num_threads; };
+
+        // 1. every thread hashes its chunk of the input and counts the keys per group
+        std::vector<int> bin_of(n);
+        std::vector<std::vector<std::size_t>> counts(num_threads, std::vector<std::size_t>(num_groups, 0));
+        run_in_parallel(num_threads, [&](int t)
+                        {
+            for (std::size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i)
+            {
+                bin_of[i] = h[0].hash(keys[i]);
+                ++counts[t][group_of(bin_of[i])];
+            } });
+
+        // 2. turn the counts into write positions, ordered by group and then by chunk (keeps the input order)
+        std::vector<std::size_t> group_begin(num_groups + 1, 0);
+        std::size_t position = 0;
+        for (int g = 0; g < num_groups; ++g)
+        {
+            group_begin[g] = position;
+            for (int t = 0; t < num_threads; ++t)
+            {
+                const std::size_t count = counts[t][g];
+                counts[t][g] = position;
+                position += count;
+            }
+        }
+        group_begin[num_groups] = position;
+
+        std::vector<T> partitioned_keys(n);
+        std::vector<int> partitioned_bins(n);
+        run_in_parallel(num_threads, [&](int t)
+                        {
+            for (std::size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i)
+            {
+                const std::size_t target = counts[t][group_of(bin_of[i])]++;
+                partitioned_keys[target] = keys[i];
+                partitioned_bins[target] = bin_of[i];
+            } });
+
+        // 3. fill the bins, group g is handled by thread g % num_threads
+        if constexpr (requires { bins.unshare(); })
+        {
+            // bins of different threads may share a chunk, it has to be copied before
+            bins.unshare();
+        }
+        std::vector<std::vector<T>> group_overflow(num_groups);
+        std::vector<int> num_inserted(num_threads, 0);
+        run_in_parallel(num_threads, [&](int t)
+                        {
+            for (int g = t; g < num_groups; g += num_threads)
+            {
+                for (std::size_t i = group_begin[g]; i < group_begin[g + 1]; ++i)
+                {
+                    SimpleBin<T, bin_capacity> &bin = bins[partitioned_bins[i]];
+                    if (bin.contains(partitioned_keys[i]))
+                    {
+                        continue;
+                    }
+                    if (bin.insert(partitioned_keys[i]))
+                    {
+                        ++num_inserted[t];
+                    }
+                    else
+                    {
+                        group_overflow[g].push_back(partitioned_keys[i]);
+                    }
+                }
+            } });
+
+        for (int t = 0; t < num_threads; ++t)
+        {
+            _size += num_inserted[t];
+        }
+        for (const std::vector<T> &keys_of_group : group_overflow)
+        {
+            overflow.insert(overflow.end(), keys_of_group.begin(), keys_of_group.end());
+        }
+        return overflow;
+    }
+
+    // calls f for every element
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (int bin = 0; bin < num_bins; ++bin)
+        {
+            std::as_const(bins)[bin].for_each(f);
+        }
+    }
+
+    // number of chunks shared with snapshots, only for copy-on-write storage (see cow_array.h)
+    std::size_t shared_chunks() const
+    {
+        return bins.shared_chunks();
+    }
+
+    // bin an element is mapped to (the first candidate if there are two)
+    int bin_index(const T &item) const
+    {
+        return h[0].hash(item);
+    }
+
+    // the array the bins are stored in, e.g. a SeqlockArray whose counters lock-free readers check
+    const Array<SimpleBin<T, bin_capacity>, num_bins> &storage() const
+    {
+        return bins;
+    }
+
+    Array<SimpleBin<T, bin_capacity>, num_bins> &storage()
+    {
+        return bins;
+    }
+
+    // memory used by the bins (elements and metadata), without the hash functions
+    static constexpr std::size_t size_in_bits()
+    {
+        return sizeof(SimpleBin<T, bin_capacity>) * num_bins * 8;
+    }
+
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage;
+        usage.bins_payload = sizeof(T) * bin_capacity * num_bins;
+        usage.bins_metadata = storage_bytes<decltype(bins)>() - usage.bins_payload;
+        usage.hash_functions = sizeof(h);
+        usage.other = sizeof(SimpleBinCollection) - sizeof(bins) - sizeof(h);
+        return usage;
+    }
+
 private:
-    std::array<SimpleBin<T, bin_capacity>, num_bins> bins;
-    TornadoHash<T> h;
+    Array<SimpleBin<T, bin_capacity>, num_bins> bins;
+    std::array<TornadoHash<T>, num_choices> h;
     int _size;
+
+    // calls f(0), .., f(num_threads - 1) concurrently, f(0) on the calling thread
+    template <typename F>
+    static void run_in_parallel(int num_threads, F f)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t)
+        {
+            threads.emplace_back(f, t);
+        }
+        f(0);
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef static_backyard_
+#define static_backyard_
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <optional>
+#include <stdexcept>
+
+#include "hash.h"
+#include "simple_bin.h"
+
+// Immutable set that is built in a constant expression from a constant list of keys, e.g.
+//     static constexpr auto set = StaticBackyard<uint32_t, 64, 8, 64>::build(keys);
+// A constexpr instance is placed in read-only data, it costs nothing at program start and needs no dynamic
+// initialisation.
+// Keys are kept in bins and the keys of full bins in two cuckoo tables, as in BackyardCuckooHashing. There is no
+// queue and no cdm: nothing is inserted after building, so an insertion may take as many steps as it needs. The
+// hash functions are derived from a seed, if the keys don't fit they are derived from the next seed and the set
+// is built again.
+template <typename T, int num_bins, int bin_capacity, int size_cuckoo_tables>
+class StaticBackyard
+{
+public:
+    // fails to compile (throws if evaluated at runtime) if no seed out of seed, .., seed + max_attempts - 1 fits
+    template <std::size_t num_keys>
+    static constexpr StaticBackyard build(const std::array<T, num_keys> &keys, uint64_t seed = 0)
+    {
+        for (int attempt = 0; attempt < max_attempts; ++attempt)
+        {
+            StaticBackyard set(seed + attempt);
+            bool complete = true;
+            for (const T &key : keys)
+            {
+                if (!set.insert(key))
+                {
+                    complete = false;
+                    break;
+                }
+            }
+            if (complete)
+            {
+                return set;
+            }
+        }
+        throw std::invalid_argument("Static Backyard: keys don't fit, use more bins or larger cuckoo tables");
+    }
+
+    constexpr bool contains(const T &item) const
+    {
+        const SimpleBin<T, bin_capacity> &bin = bins[bins_h.hash(item)];
+        if (bin.contains(item))
+        {
+            return true;
+        }
+        // only keys of full bins are in the cuckoo tables
+        if (bin.has_space())
+        {
+            return false;
+        }
+        return occupied_by(0, item) || occupied_by(1, item);
+    }
+
+    constexpr int size() const
+    {
+        return _size;
+    }
+
+    // number of keys that didn't fit into their bin
+    constexpr int backyard_size() const
+    {
+        return _backyard_size;
+    }
+
+    // seed the hash functions were derived from
+    constexpr uint64_t seed() const
+    {
+        return _seed;
+    }
+
+private:
+    // every attempt derives 3 * 2048 random numbers, the compiler limits the number of steps of a constant expression
+    static constexpr int max_attempts = 16;
+    // an insertion into the cuckoo tables that takes more steps is considered to be in a cycle
+    static constexpr int max_loop = 2 * size_cuckoo_tables + 16;
+
+    std::array<SimpleBin<T, bin_capacity>, num_bins> bins;
+    std::array<std::array<std::optional<T>, size_cuckoo_tables>, 2> cuckoo_tables;
+    TornadoHash<T> bins_h;
+    std::array<TornadoHash<T>, 2> cuckoo_tables_h;
+    uint64_t _seed;
+    int _size = 0;
+    int _backyard_size = 0;
+
+    constexpr explicit StaticBackyard(uint64_t seed)
+        : bins_h(seed), cuckoo_tables_h{TornadoHash<T>(seed ^ 0x6a09e667f3bcc908ULL),
+                                        TornadoHash<T>(seed ^ 0xbb67ae8584caa73bULL)},
+          _seed(seed)
+    {
+        bins_h.set_range(num_bins);
+        cuckoo_tables_h[0].set_range(size_cuckoo_tables);
+        cuckoo_tables_h[1].set_range(size_cuckoo_tables);
+    }
+
+    // compares explicitly, the operator== of backyard.h for optional<T> and T isn't constexpr
+    constexpr bool occupied_by(int side, const T &item) const
+    {
+        const std::optional<T> &slot = cuckoo_tables[side][cuckoo_tables_h[side].hash(item)];
+        return slot.has_value() && *slot == item;
+    }
+
+    // returns false if the element runs into a cycle in the cuckoo tables
+    constexpr bool insert(const T &item)
+    {
+        if (contains(item))
+        {
+            return true;
+        }
+        ++_size;
+        if (bins[bins_h.hash(item)].insert(item))
+        {
+            return true;
+        }
+        ++_backyard_size;
+
+        // elements of the cuckoo tables never go back to their bin, it stays full
+        T y = item;
+        int b = 0;
+        for (int i = 0; i < max_loop; ++i)
+        {
+            std::optional<T> &slot = cuckoo_tables[b][cuckoo_tables_h[b].hash(y)];
+            if (!slot.has_value())
+            {
+                slot = y;
+                return true;
+            }
+            const T z = *slot;
+            slot = y;
+            y = z;
+            b = !b;
+        }
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef tagged_bin_
+#define tagged_bin_
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <functional>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "hash.h"
+#include "memory_usage.h"
+
+// Bin for large keys (e.g. strings) where comparing two keys is expensive. Every slot stores an 8 bit tag
+// derived from the hash of its key next to the key. A lookup compares all tags at once and only compares
+// the full keys of slots whose tag matches, which happens with probability 1/256 per occupied slot.
+template <typename T, int capacity>
+class TaggedBin
+{
+    static_assert(capacity >= 1 && capacity <= 64, "TaggedBin supports bins with up to 64 slots");
+
+public:
+    TaggedBin()
+    {
+        tags.fill(0);
+        occupied = 0;
+    }
+
+    bool insert(const T &item, uint8_t tag)
+    {
+        if (!has_space())
+        {
+            return false;
+        }
+        const int slot = std::countr_one(occupied);
+        elems[slot] = item;
+        tags[slot] = tag;
+        occupied |= uint64_t(1) << slot;
+        return true;
+    }
+
+    bool remove(const T &item, uint8_t tag)
+    {
+        const int slot = find(item, tag);
+        if (slot < 0)
+        {
+            return false;
+        }
+        elems[slot] = T{};
+        occupied &= ~(uint64_t(1) << slot);
+        return true;
+    }
+
+    bool contains(const T &item, uint8_t tag) const
+    {
+        return find(item, tag) >= 0;
+    }
+
+    int size() const
+    {
+        return std::popcount(occupied);
+    }
+
+    bool has_space() const
+    {
+        return size() < capacity;
+    }
+
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (uint64_t slots = occupied; slots; slots &= slots - 1)
+        {
+            f(elems[std::countr_zero(slots)]);
+        }
+    }
+
+private:
+    // tags are padded to whole 16 byte vectors, padding slots are never occupied
+    static constexpr int num_tags = (capacity + 15) / 16 * 16;
+
+    uint64_t occupied;
+    alignas(16) std::array<uint8_t, num_tags> tags;
+    std::array<T, capacity> elems;
+
+    // bitmask of the slots whose tag equals tag
+    uint64_t match_tags(uint8_t tag) const
+    {
+        uint64_t matches = 0;
+#if defined(__SSE2__)
+        const __m128i pattern = _mm_set1_epi8(static_cast<char>(tag));
+        for (int i = 0; i < num_tags; i += 16)
+        {
+            const __m128i block = _mm_load_si128(reinterpret_cast<const __m128i *>(&tags[i]));
+            const uint64_t mask = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern)));
+            matches |= mask << i;
+        }
+#else
+        for (int i = 0; i < capacity; ++i)
+        {
+            matches |= uint64_t(tags[i] == tag) << i;
+        }
+#endif
+        return matches;
+    }
+
+    int find(const T &item, uint8_t tag) const
+    {
+        for (uint64_t candidates = match_tags(tag) & occupied; candidates; candidates &= candidates - 1)
+        {
+            const int slot = std::countr_zero(candidates);
+            if (elems[slot] == item)
+            {
+                return slot;
+            }
+        }
+        return -1;
+    }
+};
+
+// First level for large keys, the bin index and the tag are taken from the same 64 bit hash value:
+// the upper 32 bits select the bin and the lowest 8 bits are the tag
+template <typename T, int num_bins, int bin_capacity, typename Hash = std::hash<T>>
+class TaggedBinCollection
+{
+public:
+    TaggedBinCollection()
+    {
+        bins.fill(TaggedBin<T, bin_capacity>{});
+        std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
+        seed = dist(gen);
+        _size = 0;
+    }
+
+    bool insert(const T &item)
+    {
+        const uint64_t h = hash(item);
+        if (bins[bin_index(h)].insert(item, tag(h)))
+        {
+            ++_size;
+            return true;
+        }
+        return false;
+    }
+
+    bool remove(const T &item)
+    {
+        const uint64_t h = hash(item);
+        if (bins[bin_index(h)].remove(item, tag(h)))
+        {
+            --_size;
+            return true;
+        }
+        return false;
+    }
+
+    bool contains(const T &item) const
+    {
+        const uint64_t h = hash(item);
+        return bins[bin_index(h)].contains(item, tag(h));
+    }
+
+    int size() const
+    {
+        return _size;
+    }
+
+    // calls f for every element
+    template <typename F>
+    void for_each(F f) const
+    {
+        for (const TaggedBin<T, bin_capacity> &bin : bins)
+        {
+            bin.for_each(f);
+        }
+    }
+
+    // the hash functions are the key hash and the seed
+    static constexpr MemoryUsage memory_usage()
+    {
+        MemoryUsage usage;
+        usage.bins_payload = sizeof(T) * bin_capacity * num_bins;
+        usage.bins_metadata = sizeof(bins) - usage.bins_payload;
+        usage.hash_functions = sizeof(key_hash) + sizeof(seed);
+        usage.other = sizeof(TaggedBinCollection) - sizeof(bins) - sizeof(key_hash) - sizeof(seed);
+        return usage;
+    }
+
+private:
+    std::array<TaggedBin<T, bin_capacity>, num_bins> bins;
+    Hash key_hash;
+    uint64_t seed;
+    int _size;
+
+    // the result of Hash is mixed with a random seed (finalizer of murmur3), since std::hash is often the identity
+    uint64_t hash(const T &item) const
+    {
+        uint64_t h = static_cast<uint64_t>(key_hash(item)) ^ seed;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static int bin_index(uint64_t h)
+    {
+        return ((h >> 32) * num_bins) >> 32;
+    }
+
+    static uint8_t tag(uint64_t h)
+    {
+        return static_cast<uint8_t>(h);
+    }
+};
+
+#endif
@@ -0,0 +1,260 @@
+#ifndef workload_
+#define workload_
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "hash.h"
+
+// Key sequences and lookup streams for experiments and benchmarks. Every element is a function of the seed and
+// its index alone, so any range of a sequence can be generated on its own (in parallel, or in batches that never
+// exist in memory at the same time) and is the same for every partition into ranges.
+
+// uniform double in [0, 1) from the next output of splitmix64
+inline double uniform_double(uint64_t &state)
+{
+    return (splitmix64(state) >> 11) * 0x1.0p-53;
+}
+
+// Distinct pseudo random keys: key i is a seeded bijection of i, so the keys of distinct indices never collide
+// and no set of the keys generated so far is needed. Indices are taken modulo 2^w of T. Disjoint index ranges
+// give disjoint key sets, e.g. [0, n) to insert and [n, 2n) for unsuccessful lookups.
+template <typename T>
+class DistinctKeys
+{
+public:
+    explicit DistinctKeys(uint64_t seed) : permutation(seed)
+    {
+    }
+
+    T operator[](uint64_t index) const
+    {
+        return permutation.hash(T(index));
+    }
+
+    void fill(uint64_t first, T *keys, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            keys[i] = permutation.hash(T(first + i));
+        }
+    }
+
+    std::vector<T> generate(uint64_t first, uint64_t count) const
+    {
+        std::vector<T> keys(count);
+        fill(first, keys.data(), count);
+        return keys;
+    }
+
+private:
+    PermutationHash<T> permutation;
+};
+
+// Zipf distribution on the ranks [0, n): rank r is drawn with probability proportional to 1 / (r + 1)^exponent,
+// exponent 0 is the uniform distribution. Constant expected time per sample and no table, by rejection inversion
+// (Hoermann and Derflinger, "Rejection-inversion to generate variates from monotone discrete distributions").
+class ZipfDistribution
+{
+public:
+    ZipfDistribution(uint64_t n, double exponent) : n(n), exponent(exponent)
+    {
+        if (n < 1)
+        {
+            throw std::invalid_argument("Zipf Distribution: n has to be positive");
+        }
+        if (!(exponent >= 0))
+        {
+            throw std::invalid_argument("Zipf Distribution: exponent can't be negative");
+        }
+        h_integral_x1 = h_integral(1.5) - 1;
+        h_integral_n = h_integral(n + 0.5);
+        s = 2 - h_integral_inverse(h_integral(2.5) - h(2));
+    }
+
+    uint64_t operator()(uint64_t &state) const
+    {
+        while (true)
+        {
+            const double u = h_integral_n + uniform_double(state) * (h_integral_x1 - h_integral_n);
+            const double x = h_integral_inverse(u);
+            const double k = std::clamp(std::floor(x + 0.5), 1.0, double(n));
+            if (k - x <= s || u >= h_integral(k + 0.5) - h(k))
+            {
+                return uint64_t(k) - 1;
+            }
+        }
+    }
+
+private:
+    uint64_t n;
+    double exponent;
+    double h_integral_x1;
+    double h_integral_n;
+    double s;
+
+    // h(x) = x^-exponent on ranks starting at 1, h_integral is an antiderivative of it
+    double h(double x) const
+    {
+        return std::exp(-exponent * std::log(x));
+    }
+
+    double h_integral(double x) const
+    {
+        const double log_x = std::log(x);
+        return expm1_over_x((1 - exponent) * log_x) * log_x;
+    }
+
+    double h_integral_inverse(double x) const
+    {
+        const double t = std::max(-1.0, x * (1 - exponent));
+        return std::exp(log1p_over_x(t) * x);
+    }
+
+    // log(1 + x) / x and (exp(x) - 1) / x, continuous at 0 (exponent 1)
+    static double log1p_over_x(double x)
+    {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1 - x * (0.5 - x * (1.0 / 3 - 0.25 * x));
+    }
+
+    static double expm1_over_x(double x)
+    {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1 + x * 0.5 * (1 + x / 3 * (1 + 0.25 * x));
+    }
+};
+
+// hot_access_fraction of the draws go to the first hot_rank_fraction of the ranks [0, n), uniform within both parts
+class HotSetDistribution
+{
+public:
+    HotSetDistribution(uint64_t n, double hot_rank_fraction, double hot_access_fraction)
+        : n(n), hot_access_fraction(hot_access_fraction)
+    {
+        if (n < 1)
+        {
+            throw std::invalid_argument("Hot Set Distribution: n has to be positive");
+        }
+        if (!(hot_rank_fraction > 0 && hot_rank_fraction <= 1 && hot_access_fraction >= 0 &&
+              hot_access_fraction <= 1))
+        {
+            throw std::invalid_argument("Hot Set Distribution: fractions have to be in [0, 1]");
+        }
+        num_hot = std::clamp<uint64_t>(std::ceil(n * hot_rank_fraction), 1, n);
+    }
+
+    uint64_t operator()(uint64_t &state) const
+    {
+        if (uniform_double(state) < hot_access_fraction || num_hot == n)
+        {
+            return uint64_t(uniform_double(state) * num_hot);
+        }
+        return num_hot + uint64_t(uniform_double(state) * (n - num_hot));
+    }
+
+private:
+    uint64_t n;
+    double hot_access_fraction;
+    uint64_t num_hot;
+};
+
+// Lookups of keys, which are a DistinctKeys or a std::span of keys: a lookup hits with probability hit_ratio.
+// Hits go to the present keys (indices [0, num_present)), misses uniformly to the absent keys (indices
+// [num_present, num_present + num_absent)). The present keys are drawn by their rank in the distribution. The
+// ranks are scattered over the indices by a random affine bijection, so the popular keys don't depend on the
+// insertion order.
+template <typename Keys, typename Distribution = ZipfDistribution>
+class LookupStream
+{
+    using T = std::remove_cvref_t<decltype(std::declval<const Keys &>()[0])>;
+
+public:
+    LookupStream(const Keys &keys, uint64_t num_present, uint64_t num_absent, double hit_ratio,
+                 const Distribution &distribution, uint64_t seed)
+        : keys(keys), num_present(num_present), num_absent(num_absent), hit_ratio(hit_ratio),
+          distribution(distribution), seed(splitmix64(seed))
+    {
+        if (num_present < 1 || num_present > (uint64_t(1) << 32) || (hit_ratio < 1 && num_absent < 1))
+        {
+            throw std::invalid_argument("Lookup Stream: needs 1 to 2^32 present keys and absent keys for misses");
+        }
+        if (!(hit_ratio >= 0 && hit_ratio <= 1))
+        {
+            throw std::invalid_argument("Lookup Stream: hit ratio has to be in [0, 1]");
+        }
+        uint64_t state = this->seed;
+        // a multiplier coprime to num_present makes rank -> (multiplier * rank + offset) % num_present a bijection
+        do
+        {
+            multiplier = splitmix64(state) % num_present;
+        } while (std::gcd(multiplier, num_present) != 1 && num_present > 1);
+        offset = splitmix64(state) % num_present;
+    }
+
+    // the index-th lookup, its random numbers are a splitmix64 stream of its own
+    T operator[](uint64_t index) const
+    {
+        uint64_t state = seed + index * 0xd1b54a32d192ed03ULL;
+        if (uniform_double(state) < hit_ratio)
+        {
+            const uint64_t rank = distribution(state);
+            return keys[(multiplier * rank + offset) % num_present];
+        }
+        return keys[num_present + uint64_t(uniform_double(state) * num_absent)];
+    }
+
+    void fill(uint64_t first, T *lookups, std::size_t count) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            lookups[i] = (*this)[first + i];
+        }
+    }
+
+    std::vector<T> generate(uint64_t first, uint64_t count) const
+    {
+        std::vector<T> lookups(count);
+        fill(first, lookups.data(), count);
+        return lookups;
+    }
+
+private:
+    Keys keys;
+    uint64_t num_present;
+    uint64_t num_absent;
+    double hit_ratio;
+    Distribution distribution;
+    uint64_t seed;
+    uint64_t multiplier;
+    uint64_t offset;
+};
+
+// elements [first, first + count) of a DistinctKeys or LookupStream, generated by one range per thread
+template <typename T, typename Sequence>
+std::vector<T> generate_parallel(const Sequence &sequence, uint64_t first, uint64_t count,
+                                 int num_threads = std::max(1u, std::thread::hardware_concurrency()))
+{
+    std::vector<T> elements(count);
+    const uint64_t range = (count + num_threads - 1) / num_threads;
+    std::vector<std::thread> threads;
+    for (uint64_t begin = 0; begin < count; begin += range)
+    {
+        threads.emplace_back([&, begin]()
+                             { sequence.fill(first + begin, elements.data() + begin,
+                                             std::min(range, count - begin)); });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    return elements;
+}
+
+#endif
@@ -0,0 +1,87 @@
+#include <cassert>
+#include <cstdint>
+#include <unordered_set>
+#include "../src/background_backyard.h"
+
+void test_background_backyard_lookups_while_draining()
+{
+    BackgroundDrainedBackyard<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20> custom_set(10);
+
+    for (uint32_t i = 0; i < 150; ++i)
+    {
+        custom_set.insert(i);
+        // the element may still be in the queue, but it has to be found
+        assert(custom_set.contains(i));
+    }
+    assert(custom_set.size() == 150);
+
+    custom_set.wait_until_drained();
+    assert(custom_set.queue_size() == 0);
+    assert(custom_set.keeping_up());
+    for (uint32_t i = 0; i < 150; ++i)
+    {
+        assert(custom_set.contains(i));
+    }
+    assert(!custom_set.contains(1000));
+}
+
+void test_background_backyard_random_operations()
+{
+    BackgroundDrainedBackyard<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20> custom_set(10, 50);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        // at most 250 elements, so the set never runs out of space (100 bin slots and 200 cuckoo slots)
+        uint32_t value = std::rand() % 250;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+    }
+    assert(custom_set.size() == (int)std_set.size());
+
+    custom_set.wait_until_drained();
+    assert(custom_set.queue_size() == 0);
+    // inserts may have helped the drainer before, but not since the previous call
+    custom_set.keeping_up();
+    assert(custom_set.keeping_up());
+    for (uint32_t value = 0; value < 250; ++value)
+    {
+        assert(custom_set.contains(value) == (std_set.count(value) > 0));
+    }
+}
+
+void test_background_backyard_reports_lagging_drainer()
+{
+    // 1 bin slot and 4 cuckoo slots, so almost every element stays in the queue and the drainer falls behind
+    BackgroundDrainedBackyard<uint32_t, 1, 1, 2, 100, 5, 20, 20, 5> custom_set(3, 10);
+
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        custom_set.insert(i);
+    }
+    // whether an insert found the append buffer full depends on how fast the drainer empties it, but only 5
+    // elements fit into the bin and the cuckoo tables, so the backlog is above the limit either way
+    assert(custom_set.queue_size() > 10);
+    assert(!custom_set.keeping_up());
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        assert(custom_set.contains(i));
+    }
+    assert(custom_set.size() == 200);
+    assert(custom_set.remove(7) && !custom_set.contains(7));
+}
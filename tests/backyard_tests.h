@@ -1,6 +1,11 @@
 #include <cassert>
 #include <cstddef>
+#include <cmath>
 #include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <unordered_set>
 #include "../src/backyard.h"
 
@@ -154,4 +159,490 @@ void test_backyard_random_operations()
             assert(custom_contains == std_contains);
         }
     }
-}
\ No newline at end of file
+}
+
+void test_backyard_adaptive_insert_loop_iterations()
+{
+    BackyardCuckooHashing<uint32_t, 5, 2, 4, 5, 3, 10, 5, 3> dictionary(2, 10, 2, 6);
+
+    // the queue is empty, so the minimum amount of work is done
+    assert(dictionary.current_insert_loop_iterations() == 2);
+
+    dictionary.queue.push_back({100, true});
+    dictionary.queue.push_back({101, true});
+    dictionary.queue.push_back({102, true});
+    dictionary.queue.push_back({103, true});
+    // halfway between the watermarks
+    assert(dictionary.current_insert_loop_iterations() == 6);
+
+    dictionary.queue.push_back({104, true});
+    dictionary.queue.push_back({105, true});
+    dictionary.queue.push_back({106, true});
+    // above the high watermark the upper bound is used
+    assert(dictionary.current_insert_loop_iterations() == 10);
+}
+
+void test_backyard_adaptive_random_operations()
+{
+    constexpr int num_bins = 10;
+    constexpr int bin_capacity = 10;
+    constexpr int size_cuckoo_tables = 100;
+    constexpr int n_queue = 1000;
+    constexpr int k_queue = 20;
+    constexpr int num_elems_cdm = 1000;
+    constexpr int n_cdm = 1000;
+    constexpr int k_cdm = 20;
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, size_cuckoo_tables, n_queue, k_queue, num_elems_cdm, n_cdm, k_cdm>
+        custom_set(1, 20, 4, 32);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    constexpr int num_operations = 20000;
+
+    for (int i = 0; i < num_operations; ++i)
+    {
+        int operation = std::rand() % 3;     // 0: insert, 1: remove, 2: contains
+        uint32_t value = std::rand() % 1000; // Random value between 0 and 999
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            bool custom_remove = custom_set.remove(value);
+            bool std_remove = std_set.erase(value) > 0;
+            assert(custom_remove == std_remove);
+        }
+        else
+        {
+            bool custom_contains = custom_set.contains(value);
+            bool std_contains = (std_set.count(value) > 0);
+            assert(custom_contains == std_contains);
+        }
+        assert(custom_set.current_insert_loop_iterations() <= 20);
+    }
+}
+
+void test_backyard_incremental_rehash()
+{
+    BackyardCuckooHashing<uint32_t, 5, 2, 20, 50, 5, 50, 20, 5> dictionary(5);
+    std::unordered_set<uint32_t> std_set;
+
+    for (uint32_t i = 0; i < 30; ++i)
+    {
+        dictionary.insert(i * 7);
+        std_set.insert(i * 7);
+    }
+
+    dictionary.start_rehash();
+    assert(dictionary.is_rehashing());
+    assert(dictionary.rehash_count == 1);
+
+    // elements have to stay visible while they are migrated to the new hash functions
+    uint32_t value = 1000;
+    while (dictionary.is_rehashing())
+    {
+        dictionary.insert(value);
+        std_set.insert(value);
+        ++value;
+        for (uint32_t elem : std_set)
+        {
+            assert(dictionary.contains(elem));
+        }
+    }
+
+    // removal of elements that were placed before the rehash
+    for (uint32_t i = 0; i < 30; i += 2)
+    {
+        assert(dictionary.remove(i * 7));
+        std_set.erase(i * 7);
+    }
+    for (uint32_t elem : std_set)
+    {
+        assert(dictionary.contains(elem));
+    }
+    assert(dictionary.size() == (int)std_set.size());
+}
+
+void test_backyard_rehash_on_sustained_queue_growth()
+{
+    // backyard that is too small, so elements pile up in the queue
+    BackyardCuckooHashing<uint32_t, 1, 1, 2, 20, 5, 20, 20, 5> dictionary(3);
+    dictionary.set_rehash_policy(2, 4, 1);
+
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        dictionary.insert(i);
+    }
+
+    assert(dictionary.rehash_count > 0);
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        assert(dictionary.contains(i));
+    }
+
+    // the elements don't fit under any hash functions, so the queue doesn't shrink and the rehashes stop
+    for (int i = 0; i < 500; ++i)
+    {
+        dictionary.insert(i % 20);
+    }
+    assert(dictionary.rehash_count <= dictionary.max_consecutive_rehashes);
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        assert(dictionary.contains(i));
+    }
+
+    // without a policy the set is never rehashed
+    BackyardCuckooHashing<uint32_t, 1, 1, 2, 20, 5, 20, 20, 5> default_dictionary(3);
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        default_dictionary.insert(i);
+    }
+    assert(default_dictionary.rehash_count == 0);
+}
+
+void test_backyard_rehash_recovers_from_bad_hash_functions()
+{
+    using Set = BackyardCuckooHashing<uint32_t, 1000, 4, 2000, 1000, 10, 500, 500, 10>;
+    std::unique_ptr<Set> set = std::make_unique<Set>(8);
+    set->set_rehash_policy(8, 16, 16);
+    // a bad draw: both tables use the same hash function, so the elements that hash to a slot that is occupied
+    // in both tables cycle between the queue and the tables
+    set->cuckoo_tables_h[1] = set->cuckoo_tables_h[0];
+
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < 4000; ++i)
+    {
+        keys.push_back(i * 2654435761u);
+        set->insert(keys.back());
+    }
+    assert(set->rehash_count > 0);
+
+    // the new hash functions place every element, so the queue drains
+    for (int i = 0; i < 10000 && (!set->queue.empty() || set->is_rehashing()); ++i)
+    {
+        set->process_queue(8);
+    }
+    assert(set->queue.empty() && !set->is_rehashing());
+    assert(set->rehash_count <= set->max_consecutive_rehashes);
+    assert(set->size() == 4000);
+    for (uint32_t key : keys)
+    {
+        assert(set->contains(key));
+    }
+}
+
+void test_backyard_two_choice_bins()
+{
+    constexpr int num_bins = 10;
+    constexpr int bin_capacity = 10;
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, 100, 1000, 20, 1000, 1000, 20,
+                          SimpleBinCollection<uint32_t, num_bins, bin_capacity, 2>>
+        custom_set(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+    }
+}
+
+void test_backyard_build_from()
+{
+    constexpr int num_bins = 10;
+    constexpr int bin_capacity = 10;
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, 100, 1000, 20, 1000, 1000, 20> custom_set(10);
+    // two-choice bins fall back to sequential insertion
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, 100, 1000, 20, 1000, 1000, 20,
+                          SimpleBinCollection<uint32_t, num_bins, bin_capacity, 2>>
+        two_choice_set(10);
+    std::vector<uint32_t> keys;
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+    for (int i = 0; i < 200; ++i)
+    {
+        keys.push_back(std::rand() % 250);
+        std_set.insert(keys.back());
+    }
+
+    custom_set.build_from(keys, 4);
+    two_choice_set.build_from(keys, 4);
+    assert(custom_set.size() == (int)std_set.size());
+    assert(two_choice_set.size() == (int)std_set.size());
+    for (uint32_t value = 0; value < 250; ++value)
+    {
+        assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        assert(two_choice_set.contains(value) == (std_set.count(value) > 0));
+    }
+
+    // the result behaves like a set filled by insert
+    for (uint32_t value = 0; value < 250; value += 2)
+    {
+        assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+    }
+    assert(custom_set.size() == (int)std_set.size());
+
+    bool thrown = false;
+    try
+    {
+        custom_set.build_from(keys);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_backyard_save_and_load()
+{
+    using Set = BackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20>;
+    const std::string path = (std::filesystem::temp_directory_path() / "backyard_snapshot_test.bin").string();
+    std::unique_ptr<Set> custom_set = std::make_unique<Set>(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+    // more elements than the bins can hold, so elements are spread over bins, cuckoo tables and the queue
+    for (int i = 0; i < 250; ++i)
+    {
+        uint32_t value = std::rand() % 1000;
+        custom_set->insert(value);
+        std_set.insert(value);
+    }
+    custom_set->start_rehash();
+    custom_set->save(path);
+
+    // a new instance samples different hash functions, load has to replace them
+    std::unique_ptr<Set> loaded_set = std::make_unique<Set>(5);
+    loaded_set->load(path);
+    assert(loaded_set->size() == custom_set->size());
+    assert(loaded_set->is_rehashing());
+    assert(loaded_set->queue.to_vector() == custom_set->queue.to_vector());
+    for (uint32_t value = 0; value < 1000; ++value)
+    {
+        assert(loaded_set->contains(value) == (std_set.count(value) > 0));
+    }
+
+    // the loaded set keeps working
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint32_t value = std::rand() % 300;
+        if (std::rand() % 2)
+        {
+            loaded_set->insert(value);
+            std_set.insert(value);
+        }
+        else
+        {
+            assert(loaded_set->remove(value) == (std_set.erase(value) > 0));
+        }
+    }
+    assert(loaded_set->size() == (int)std_set.size());
+    // the rehash that was in progress when the snapshot was written is finished
+    assert(!loaded_set->is_rehashing());
+
+    // snapshots of other configurations are rejected
+    std::unique_ptr<BackyardCuckooHashing<uint32_t, 10, 10, 50, 1000, 20, 1000, 1000, 20>> other_set =
+        std::make_unique<BackyardCuckooHashing<uint32_t, 10, 10, 50, 1000, 20, 1000, 1000, 20>>(10);
+    bool thrown = false;
+    try
+    {
+        other_set->load(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    std::filesystem::remove(path);
+}
+
+void test_backyard_snapshot()
+{
+    using Set = CowBackyardCuckooHashing<uint32_t, 1000, 8, 1000, 1000, 20, 1000, 1000, 20>;
+    std::unique_ptr<Set> custom_set = std::make_unique<Set>(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+    for (int i = 0; i < 6000; ++i)
+    {
+        uint32_t value = std::rand() % 20000;
+        custom_set->insert(value);
+        std_set.insert(value);
+    }
+
+    std::shared_ptr<const Set> snapshot = custom_set->snapshot();
+    const std::unordered_set<uint32_t> snapshot_std_set = std_set;
+    // all chunks are shared right after taking the snapshot
+    assert(snapshot->bins.size() == custom_set->bins.size());
+    assert(custom_set->cuckoo_tables[0].shared_chunks() == custom_set->cuckoo_tables[0].num_chunks);
+
+    // a reader checks the snapshot while the set keeps changing
+    std::thread reader([&snapshot, &snapshot_std_set]()
+                       {
+        for (int round = 0; round < 3; ++round)
+        {
+            for (uint32_t value = 0; value < 20000; ++value)
+            {
+                assert(snapshot->contains(value) == (snapshot_std_set.count(value) > 0));
+            }
+        } });
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint32_t value = std::rand() % 20000;
+        if (std::rand() % 2)
+        {
+            custom_set->insert(value);
+            std_set.insert(value);
+        }
+        else
+        {
+            assert(custom_set->remove(value) == (std_set.erase(value) > 0));
+        }
+    }
+    reader.join();
+
+    assert(snapshot->size() == (int)snapshot_std_set.size());
+    assert(custom_set->size() == (int)std_set.size());
+    for (uint32_t value = 0; value < 20000; ++value)
+    {
+        assert(custom_set->contains(value) == (std_set.count(value) > 0));
+    }
+}
+
+void test_backyard_snapshot_reads_dont_copy_chunks()
+{
+    using Set = CowBackyardCuckooHashing<uint32_t, 1000, 8, 1000, 1000, 20, 1000, 1000, 20>;
+    std::unique_ptr<Set> custom_set = std::make_unique<Set>(10);
+    for (uint32_t value = 0; value < 7000; ++value)
+    {
+        custom_set->insert(value * 2654435761u);
+    }
+    while (!custom_set->queue.empty())
+    {
+        custom_set->process_queue(10);
+    }
+    std::shared_ptr<const Set> snapshot = custom_set->snapshot();
+    const std::size_t shared_bin_chunks = custom_set->bins.shared_chunks();
+    const std::size_t shared_table_chunks = custom_set->cuckoo_tables[0].shared_chunks() +
+                                            custom_set->cuckoo_tables[1].shared_chunks();
+    assert(shared_bin_chunks > 0 && shared_table_chunks > 0);
+
+    // elements per bin, to find elements whose bin is full
+    std::vector<int> bin_sizes(1000, 0);
+    custom_set->bins.for_each([&custom_set, &bin_sizes](const uint32_t &item)
+                              { ++bin_sizes[custom_set->bins.bin_index(item)]; });
+    int failed_inserts = 0;
+    for (uint32_t value = 0; value < 14000; ++value)
+    {
+        const uint32_t item = value * 2654435761u;
+        assert(custom_set->contains(item) == (value < 7000));
+        // lookups, removals of absent elements and inserts of present ones
+        if (value >= 7000)
+        {
+            assert(!custom_set->remove(item));
+            if (bin_sizes[custom_set->bins.bin_index(item)] == 8)
+            {
+                assert(!custom_set->bins.insert(item));
+                ++failed_inserts;
+            }
+        }
+        else
+        {
+            custom_set->insert(item);
+        }
+    }
+    assert(failed_inserts > 0);
+    assert(custom_set->bins.shared_chunks() == shared_bin_chunks);
+    assert(custom_set->cuckoo_tables[0].shared_chunks() + custom_set->cuckoo_tables[1].shared_chunks() ==
+           shared_table_chunks);
+
+#ifdef BACKYARD_STATS
+    // lookups on a snapshot leave its statistics unchanged, so many readers can share it
+    const uint64_t bin_probes = snapshot->stats().bin_probes;
+    assert(snapshot->contains(0) && !snapshot->contains(7000 * 2654435761u));
+    assert(snapshot->stats().bin_probes == bin_probes);
+#endif
+}
+
+template <typename Set>
+concept HasStats = requires(const Set &set) { set.stats(); };
+
+void test_backyard_stats()
+{
+    using Set = BackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20>;
+#ifdef BACKYARD_STATS
+    Set custom_set(10);
+    // more elements than the bins can hold
+    for (uint32_t value = 0; value < 150; ++value)
+    {
+        custom_set.insert(value);
+    }
+    assert(custom_set.contains(0));
+
+    const BackyardStats stats = custom_set.stats();
+    assert(stats.bin_placements == (uint64_t)custom_set.bins.size());
+    // without removals every element was placed once or still waits in the queue
+    assert(stats.bin_placements + stats.cuckoo_table_placements + custom_set.queue.size() ==
+           (uint64_t)custom_set.size());
+    assert(stats.cuckoo_table_placements > 0);
+    assert(stats.queue_push_backs >= 150);
+    assert(stats.bin_probes >= 151);
+    assert(stats.peak_queue_size >= 1);
+    assert(stats.longest_eviction_walk <= stats.evictions);
+#else
+    // without BACKYARD_STATS nothing is counted and there are no counters to read
+    static_assert(!HasStats<Set>);
+#endif
+}
+
+void test_backyard_memory_usage()
+{
+    using Set = BackyardCuckooHashing<uint32_t, 1000, 8, 1000, 1000, 20, 1000, 1000, 20>;
+    constexpr MemoryUsage usage = Set::memory_usage();
+    // with std::array storage everything lives inside the object
+    static_assert(usage.total() == sizeof(Set));
+    assert(usage.bins_payload == 1000 * 8 * sizeof(uint32_t));
+    assert(usage.cuckoo_tables_payload == 2 * 1000 * sizeof(uint32_t));
+    // std::optional<uint32_t> doubles a slot, the epoch flags add another byte
+    assert(usage.cuckoo_tables_overhead == 2 * 1000 * (sizeof(uint32_t) + 1));
+    assert(usage.queue_nodes == 20 * 1000 * sizeof(QueueNode<std::pair<uint32_t, bool>>));
+    assert(usage.cdm_nodes == 1000 * sizeof(CdmNode<std::pair<uint32_t, bool>>));
+    assert(usage.cdm_arrays == 20 * 1000 * sizeof(int));
+    // the bins and both generations of cuckoo table hash functions are tornado hashes of 16 KiB each
+    assert(usage.hash_functions >= 5 * 16384);
+    Set custom_set(10);
+    assert(custom_set.memory_usage().total() == usage.total());
+
+    // copy-on-write storage keeps the bins and cuckoo tables outside of the object
+    using CowSet = CowBackyardCuckooHashing<uint32_t, 1000, 8, 1000, 1000, 20, 1000, 1000, 20>;
+    constexpr MemoryUsage cow_usage = CowSet::memory_usage();
+    assert(cow_usage.bins_payload == usage.bins_payload);
+    assert(cow_usage.total() > usage.total());
+    assert(cow_usage.total() > sizeof(CowSet));
+
+    assert(usage.bits_per_key(1000) == usage.total() * 8.0 / 1000);
+    // log2(binomial(2^32, n)) / n is about 32 - log2(n) + log2(e)
+    assert(std::abs(lower_bound_bits_per_key(32, 10000) - 20.1542) < 1e-3);
+}
@@ -0,0 +1,97 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../src/backyard.h"
+#include "../src/backyard_trace.h"
+
+void test_trace_ring_keeps_last_events()
+{
+    TraceRing<8> ring;
+    for (uint32_t i = 1; i <= 20; ++i)
+    {
+        ring.record({i * 10, i, i + 1000, uint8_t(i % 2), TraceEventType::displacement});
+    }
+    assert(ring.size() == 20);
+
+    const std::vector<TraceEvent> events = ring.events();
+    assert(events.size() == 8);
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const TraceEvent &event = events[i];
+        assert(event.insert_number == 13 + i);
+        assert(event.key == event.insert_number * 10);
+        assert(event.slot == event.insert_number + 1000);
+        assert(event.side == event.insert_number % 2);
+        assert(event.type == TraceEventType::displacement);
+    }
+}
+
+void test_trace_ring_write_and_read()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "backyard_trace_test.bin").string();
+    TraceRing<16> ring;
+    ring.record({42, 1, 0, 0, TraceEventType::insert_begin});
+    ring.record({42, 1, 7, 1, TraceEventType::cuckoo_placement});
+    ring.write(path);
+
+    const std::vector<TraceEvent> events = read_trace(path);
+    assert(events.size() == 2);
+    assert(events[1].key == 42 && events[1].slot == 7 && events[1].side == 1);
+    assert(events[1].type == TraceEventType::cuckoo_placement);
+
+    // a number of events that doesn't fit into the file is rejected before anything is allocated
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(8);
+        const uint64_t num_events = uint64_t(1) << 60;
+        file.write(reinterpret_cast<const char *>(&num_events), sizeof(num_events));
+    }
+    bool thrown = false;
+    try
+    {
+        read_trace(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    std::filesystem::remove(path);
+}
+
+template <typename Set>
+concept HasTrace = requires(const Set &set) { set.trace(); };
+
+void test_backyard_trace()
+{
+    using Set = BackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20>;
+#ifdef BACKYARD_TRACE
+    Set custom_set(10);
+    // more elements than the bins can hold, so some inserts evict elements in the cuckoo tables
+    for (uint32_t value = 0; value < 150; ++value)
+    {
+        custom_set.insert(value);
+    }
+
+    int num_inserts = 0;
+    int num_placements = 0;
+    uint32_t last_insert = 0;
+    for (const TraceEvent &event : custom_set.trace().events())
+    {
+        assert(event.insert_number >= last_insert);
+        last_insert = event.insert_number;
+        num_inserts += event.type == TraceEventType::insert_begin;
+        num_placements += event.type == TraceEventType::cuckoo_placement;
+    }
+    assert(last_insert == 150);
+    assert(num_inserts > 0);
+    assert(num_placements > 0);
+#else
+    // without BACKYARD_TRACE nothing is recorded and there is no buffer
+    static_assert(!HasTrace<Set>);
+#endif
+}
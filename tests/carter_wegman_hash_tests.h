@@ -4,7 +4,7 @@
 #include <unordered_set>
 #include "../src/hash.h"
 
-void test_hash_set_range()
+void test_carter_wegman_hash_set_range()
 {
     CarterWegmanHash<uint64_t> hash_func = CarterWegmanHash<uint64_t>();
     hash_func.set_range(100); // Set the range to 100
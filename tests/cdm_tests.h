@@ -1,6 +1,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
 #include <unordered_set>
 #include "../src/cdm.h"
 
@@ -133,6 +134,28 @@ void test_collection_empty()
     assert(!collection.empty());
 }
 
+void test_collection_capacity()
+{
+    ConstantTimeCollection<uint64_t, 3, 5, 3> collection;
+    collection.insert(1);
+    collection.insert(2);
+    collection.insert(3);
+
+    // one element more than the collection holds is rejected instead of being written past its end
+    bool thrown = false;
+    try
+    {
+        collection.insert(4);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(collection.contains(1) && collection.contains(2) && collection.contains(3));
+    assert(!collection.contains(4));
+}
+
 void test_cdm_duplicate_inserts()
 {
     ConstantTimeCollection<uint64_t, 10, 5, 3> collection;
@@ -0,0 +1,104 @@
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <unordered_set>
+#include "../src/concurrent_backyard.h"
+
+void test_concurrent_backyard_random_operations()
+{
+    ConcurrentBackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20, 4> custom_set(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+        assert(custom_set.size() == (int)std_set.size());
+    }
+}
+
+void test_concurrent_backyard_parallel_writers()
+{
+    // small bins, so many elements take the backyard path
+    ConcurrentBackyardCuckooHashing<uint32_t, 100, 4, 400, 500, 10, 500, 200, 10, 8> custom_set(10);
+    constexpr int num_threads = 4;
+    constexpr uint32_t elements_per_thread = 150;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&custom_set, t]()
+                             {
+            // every thread inserts its own elements and removes every other one again
+            for (uint32_t i = 0; i < elements_per_thread; ++i)
+            {
+                custom_set.insert(t * 1000 + i);
+            }
+            for (uint32_t i = 0; i < elements_per_thread; i += 2)
+            {
+                assert(custom_set.remove(t * 1000 + i));
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < num_threads; ++t)
+    {
+        for (uint32_t i = 0; i < elements_per_thread; ++i)
+        {
+            assert(custom_set.contains(t * 1000 + i) == (i % 2 == 1));
+        }
+    }
+    assert(custom_set.size() == num_threads * elements_per_thread / 2);
+}
+
+void test_concurrent_backyard_adaptive_insert_loop_and_rehash()
+{
+    // backyard that is too small, so elements pile up in the queue and the shared insert loop rehashes
+    ConcurrentBackyardCuckooHashing<uint32_t, 1, 1, 2, 20, 5, 20, 20, 5, 1> custom_set(1, 8, 2, 10);
+    custom_set.set_rehash_policy(2, 4, 1);
+    constexpr int num_threads = 4;
+    constexpr uint32_t elements_per_thread = 5;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&custom_set, t]()
+                             {
+            for (uint32_t i = 0; i < elements_per_thread; ++i)
+            {
+                custom_set.insert(t * elements_per_thread + i);
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    assert(custom_set.rehash_count() > 0);
+    for (uint32_t i = 0; i < num_threads * elements_per_thread; ++i)
+    {
+        assert(custom_set.contains(i));
+    }
+    assert(custom_set.size() == num_threads * elements_per_thread);
+    assert(custom_set.remove(3) && !custom_set.contains(3));
+}
@@ -0,0 +1,29 @@
+#include <cassert>
+#include <cstdint>
+#include "../src/cow_array.h"
+
+void test_cow_array_copies_share_chunks()
+{
+    CowArray<uint32_t, 5000> array;
+    static_assert(CowArray<uint32_t, 5000>::chunk_size == 1024);
+    array.fill(7);
+    assert(array[0] == 7 && array[4999] == 7);
+
+    const CowArray<uint32_t, 5000> copy = array;
+    assert(array.shared_chunks() == 5);
+
+    // only the written chunk is copied, the copy keeps the old value
+    array[2000] = 42;
+    assert(array[2000] == 42);
+    assert(copy[2000] == 7);
+    assert(array.shared_chunks() == 4);
+    assert(copy.shared_chunks() == 4);
+
+    // writing the same chunk again doesn't copy it again
+    array[2001] = 43;
+    assert(array.shared_chunks() == 4);
+
+    array.unshare();
+    assert(array.shared_chunks() == 0);
+    assert(copy[2001] == 7 && array[2001] == 43);
+}
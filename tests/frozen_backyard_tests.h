@@ -0,0 +1,158 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../src/backyard.h"
+#include "../src/frozen_backyard.h"
+
+void test_frozen_backyard_contains()
+{
+    using Set = BackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20>;
+    const std::string path = (std::filesystem::temp_directory_path() / "frozen_backyard_test.bin").string();
+    std::unique_ptr<Set> custom_set = std::make_unique<Set>(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+    // more elements than the bins can hold, so the frozen set has a backyard
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint32_t value = std::rand() % 1000;
+        if (std::rand() % 3)
+        {
+            custom_set->insert(value);
+            std_set.insert(value);
+        }
+        else
+        {
+            custom_set->remove(value);
+            std_set.erase(value);
+        }
+    }
+    freeze(*custom_set, path);
+
+    FrozenBackyard<uint32_t> frozen_set(path);
+    assert(frozen_set.size() == std_set.size());
+    assert(frozen_set.backyard_size() > 0);
+    for (uint32_t value = 0; value < 2000; ++value)
+    {
+        assert(frozen_set.contains(value) == (std_set.count(value) > 0));
+    }
+    std::filesystem::remove(path);
+}
+
+void test_frozen_backyard_empty_and_invalid_files()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "frozen_backyard_test.bin").string();
+    FrozenBackyard<uint32_t>::write(path, {}, 10, 4);
+    {
+        FrozenBackyard<uint32_t> frozen_set(path);
+        assert(frozen_set.size() == 0);
+        assert(!frozen_set.contains(0));
+    }
+
+    // a snapshot written by save isn't a frozen backyard
+    std::ofstream(path, std::ios::binary) << "not a frozen backyard, but long enough to hold a header";
+    bool thrown = false;
+    try
+    {
+        FrozenBackyard<uint32_t> frozen_set(path);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    std::filesystem::remove(path);
+}
+
+// copy of the file at path with the value at position replaced
+template <typename U>
+std::string write_corrupt_frozen_backyard(const std::string &path, std::size_t position, U value)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::memcpy(bytes.data() + position, &value, sizeof(U));
+    const std::string corrupt_path = path + ".corrupt";
+    std::ofstream(corrupt_path, std::ios::binary) << bytes;
+    return corrupt_path;
+}
+
+// checks that opening and verifying a corrupt copy of the file at path throws
+template <typename U>
+void assert_frozen_backyard_rejects(const std::string &path, std::size_t position, U value)
+{
+    const std::string corrupt_path = write_corrupt_frozen_backyard(path, position, value);
+    bool thrown = false;
+    try
+    {
+        FrozenBackyard<uint32_t> frozen_set(corrupt_path);
+        frozen_set.verify();
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+    std::filesystem::remove(corrupt_path);
+}
+
+void test_frozen_backyard_corrupt_files()
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "frozen_backyard_test.bin").string();
+    std::vector<uint32_t> keys(1000);
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        keys[i] = i * 2654435761u;
+    }
+    FrozenBackyard<uint32_t>::write(path, keys, 100, 8);
+    uint64_t bin_offsets_offset, file_size;
+    {
+        FrozenBackyard<uint32_t> frozen_set(path);
+        assert(frozen_set.size() == 1000 && frozen_set.backyard_size() > 0);
+        std::ifstream in(path, std::ios::binary);
+        // positions of the fields in the header
+        in.seekg(64);
+        in.read(reinterpret_cast<char *>(&bin_offsets_offset), sizeof(uint64_t));
+        in.seekg(96);
+        in.read(reinterpret_cast<char *>(&file_size), sizeof(uint64_t));
+    }
+
+    // more bins than there are offsets in the file
+    assert_frozen_backyard_rejects<uint64_t>(path, 16, 1000000);
+    // fewer bins than the hash function of the bins returns
+    assert_frozen_backyard_rejects<uint64_t>(path, 16, 99);
+    // bin keys not aligned
+    assert_frozen_backyard_rejects<uint64_t>(path, 72, bin_offsets_offset + 8);
+    // bucket offsets outside of the file
+    assert_frozen_backyard_rejects<uint64_t>(path, 80, file_size + 64);
+    // a bin that ends before it begins, and one with more keys than its capacity
+    assert_frozen_backyard_rejects<uint32_t>(path, bin_offsets_offset + 4, 1000);
+    assert_frozen_backyard_rejects<uint32_t>(path, bin_offsets_offset + 4, 9);
+
+    // without verify, the lookups of the keys of the first two bins detect the corrupt offset
+    const std::string corrupt_path = write_corrupt_frozen_backyard<uint32_t>(path, bin_offsets_offset + 4, 1000);
+    {
+        FrozenBackyard<uint32_t> frozen_set(corrupt_path);
+        int num_thrown = 0;
+        for (uint32_t key : keys)
+        {
+            try
+            {
+                frozen_set.contains(key);
+            }
+            catch (const std::runtime_error &)
+            {
+                ++num_thrown;
+            }
+        }
+        assert(num_thrown > 0);
+    }
+    std::filesystem::remove(corrupt_path);
+    std::filesystem::remove(path);
+}
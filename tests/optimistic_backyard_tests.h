@@ -0,0 +1,86 @@
+#include <cassert>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unordered_set>
+#include "../src/optimistic_backyard.h"
+
+void test_optimistic_backyard_random_operations()
+{
+    OptimisticBackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20> custom_set(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+        assert(custom_set.size() == (int)std_set.size());
+    }
+}
+
+void test_optimistic_backyard_readers_during_evictions()
+{
+    // small bins, so most elements live in the backyard and are moved around by evictions
+    OptimisticBackyardCuckooHashing<uint32_t, 50, 2, 300, 500, 10, 500, 200, 10> custom_set(10);
+
+    // elements that stay in the set during the whole test
+    constexpr uint32_t num_stable_elements = 150;
+    for (uint32_t i = 0; i < num_stable_elements; ++i)
+    {
+        custom_set.insert(i);
+    }
+
+    std::atomic<bool> done = false;
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t)
+    {
+        readers.emplace_back([&custom_set, &done]()
+                             {
+            while (!done.load())
+            {
+                for (uint32_t i = 0; i < num_stable_elements; ++i)
+                {
+                    assert(custom_set.contains(i));
+                    // elements that are never inserted
+                    assert(!custom_set.contains(1000000 + i));
+                }
+            } });
+    }
+
+    // the writer keeps inserting and removing other elements, which evicts the stable ones
+    std::srand(42);
+    for (int i = 0; i < 20000; ++i)
+    {
+        uint32_t value = 1000 + std::rand() % 200;
+        if (std::rand() % 2)
+        {
+            custom_set.insert(value);
+        }
+        else
+        {
+            custom_set.remove(value);
+        }
+    }
+    done.store(true);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+}
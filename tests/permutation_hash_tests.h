@@ -0,0 +1,53 @@
+#include <cassert>
+#include <cstdint>
+#include <unordered_set>
+#include "../src/hash.h"
+
+void test_permutation_hash_is_invertible()
+{
+    PermutationHash<uint32_t> h32;
+    PermutationHash<uint64_t> h64;
+
+    uint32_t values32[] = {0, 1, 42, 123456789, UINT32_MAX};
+    for (uint32_t value : values32)
+    {
+        assert(h32.invert(h32.hash(value)) == value);
+    }
+    uint64_t values64[] = {0, 1, 42, 123456789123456789ULL, UINT64_MAX};
+    for (uint64_t value : values64)
+    {
+        assert(h64.invert(h64.hash(value)) == value);
+    }
+}
+
+void test_permutation_hash_is_injective()
+{
+    PermutationHash<uint32_t> h;
+    std::unordered_set<uint32_t> hash_values;
+
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        assert(hash_values.insert(h.hash(i)).second);
+    }
+}
+
+void test_permutation_hash_randomize_parameters()
+{
+    PermutationHash<uint32_t> h;
+    uint32_t before = h.hash(12345);
+    h.randomize_parameters();
+
+    // Probability of collision is negligible
+    assert(h.hash(12345) != before);
+    assert(h.invert(h.hash(12345)) == 12345);
+}
+
+void test_permutation_hash_from_seed()
+{
+    constexpr PermutationHash<uint32_t> h(42);
+    static_assert(h.hash(12345) != 12345);
+    assert(h.invert(h.hash(12345)) == 12345);
+    // the same parameters for the same seed
+    assert(PermutationHash<uint32_t>(42).hash(12345) == h.hash(12345));
+    assert(PermutationHash<uint32_t>(43).hash(12345) != h.hash(12345));
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include "../src/planner.h"
+
+void test_planner_plan()
+{
+    constexpr BackyardPlan plan = BackyardPlanner<uint32_t>::plan(2000, 0.9, 8);
+    static_assert(plan.num_bins * plan.bin_capacity * 0.9 >= 2000);
+    static_assert(plan.insert_loop_iterations == 8);
+    // the cuckoo tables stay below half full even with the largest overflow
+    static_assert(2 * plan.size_cuckoo_tables > 2 * plan.max_overflow);
+    static_assert(plan.num_elems_cdm >= plan.max_eviction_walk);
+    static_assert(plan.n_queue * plan.k_queue >= plan.max_queue_length);
+
+    // the estimate covers everything but the bookkeeping members
+    using Set = PlannedBackyardCuckooHashing<uint32_t, plan>;
+    assert(plan.memory_bytes == Set::memory_usage().total() - Set::memory_usage().other);
+
+    // the same plan at runtime
+    const BackyardPlan runtime_plan = BackyardPlanner<uint32_t>::plan(2000, 0.9, 8);
+    assert(runtime_plan.memory_bytes == plan.memory_bytes && runtime_plan.num_bins == plan.num_bins);
+
+    // a higher load needs fewer bins but more space behind them
+    const BackyardPlan full = BackyardPlanner<uint32_t>::plan(2000, 1.0, 8);
+    assert(full.num_bins * full.bin_capacity <= plan.num_bins * plan.bin_capacity);
+    assert(full.max_overflow > plan.max_overflow);
+
+    for (auto [capacity, load_factor, latency_budget] :
+         {std::tuple{0, 0.9, 8}, std::tuple{2000, 0.0, 8}, std::tuple{2000, 1.5, 8}, std::tuple{2000, 0.9, 1}})
+    {
+        bool thrown = false;
+        try
+        {
+            BackyardPlanner<uint32_t>::plan(capacity, load_factor, latency_budget);
+        }
+        catch (const std::invalid_argument &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void test_planned_backyard_holds_capacity()
+{
+    constexpr BackyardPlan plan = BackyardPlanner<uint32_t>::plan(2000, 1.0, 2);
+    using Set = PlannedBackyardCuckooHashing<uint32_t, plan>;
+    std::unique_ptr<Set> custom_set = std::make_unique<Set>(plan.insert_loop_iterations);
+
+    std::mt19937 gen(42);
+    std::vector<uint32_t> keys;
+    int max_queue_length = 0;
+    for (int i = 0; i < 2000; ++i)
+    {
+        keys.push_back(gen());
+        custom_set->insert(keys.back());
+        max_queue_length = std::max(max_queue_length, custom_set->queue.size());
+    }
+    for (uint32_t key : keys)
+    {
+        assert(custom_set->contains(key));
+    }
+    assert(custom_set->size() - custom_set->bins.size() <= plan.max_overflow);
+    assert(max_queue_length <= plan.max_queue_length);
+    assert(custom_set->queue.rebuilds() == 0);
+}
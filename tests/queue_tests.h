@@ -1,8 +1,14 @@
 #include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <array>
 #include <deque>
+#include <stdexcept>
+#include <string>
 #include <unordered_set>
+#include <utility>
 #include <algorithm>
+#include <sstream>
 #include "../src/queue.h"
 
 void test_queue_push_back()
@@ -205,4 +211,76 @@ void test_queue_random_operations()
         assert(custom_queue_as_vector_2 == ref_deque_as_vector_2);
         assert(custom_queue.size() == ref_deque.size());
     }
-}
\ No newline at end of file
+}
+
+void test_queue_save_and_load()
+{
+    ConstantTimeQueue<uint64_t, 10, 3> queue = ConstantTimeQueue<uint64_t, 10, 3>();
+    queue.push_back(2);
+    queue.push_back(3);
+    queue.push_front(1);
+    std::stringstream snapshot;
+    queue.save(snapshot);
+
+    ConstantTimeQueue<uint64_t, 10, 3> loaded_queue = ConstantTimeQueue<uint64_t, 10, 3>();
+    loaded_queue.push_back(42);
+    loaded_queue.load(snapshot);
+    assert(!loaded_queue.contains(42));
+    assert(loaded_queue.size() == 3);
+    assert(loaded_queue.pop_front().value() == 1);
+    assert(loaded_queue.pop_front().value() == 2);
+    assert(loaded_queue.pop_front().value() == 3);
+    assert(loaded_queue.empty());
+}
+
+void test_queue_load_restores_positions()
+{
+    // about half of the 16 positions are used until an element finds both of its positions taken
+    using Queue = ConstantTimeQueue<uint64_t, 8, 2>;
+    Queue queue;
+    uint64_t last = 0;
+    for (; queue.rebuilds() == 0; ++last)
+    {
+        queue.push_back(last * 7919);
+        if (queue.size() > 8)
+        {
+            queue.pop_front();
+        }
+    }
+    queue.push_back(last * 7919);
+    queue.remove((last - 2) * 7919);
+    std::stringstream snapshot;
+    queue.save(snapshot);
+
+    // loading doesn't rebuild, the loaded queue has the elements at the same positions, so it saves the same bytes
+    Queue loaded_queue;
+    loaded_queue.load(snapshot);
+    assert(loaded_queue.rebuilds() == 0);
+    assert(loaded_queue.to_vector() == queue.to_vector());
+    std::stringstream second_snapshot;
+    loaded_queue.save(second_snapshot);
+    assert(second_snapshot.str() == snapshot.str());
+
+    // more elements than the queue can hold, and a first element at a position outside of the arrays
+    const std::size_t count_position = sizeof(std::array<CarterWegmanHash<uint64_t>, 2>);
+    const std::array<std::pair<std::size_t, uint64_t>, 2> corruptions = {{{count_position, 1000},
+                                                                          {count_position + 8, 16}}};
+    for (const auto &[position, value] : corruptions)
+    {
+        std::string bytes = snapshot.str();
+        std::memcpy(bytes.data() + position, &value, position == count_position ? 8 : 4);
+        std::stringstream corrupt_snapshot(bytes);
+        bool thrown = false;
+        try
+        {
+            loaded_queue.load(corrupt_snapshot);
+        }
+        catch (const std::runtime_error &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        // the queue is unchanged
+        assert(loaded_queue.to_vector() == queue.to_vector());
+    }
+}
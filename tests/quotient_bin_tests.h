@@ -0,0 +1,184 @@
+#include <cassert>
+#include <cstdint>
+#include <unordered_set>
+#include "../src/quotient_bin.h"
+#include "../src/backyard.h"
+
+void test_quotient_bin_collection_insertion()
+{
+    QuotientBinCollection<uint32_t, 5, 5> bins;
+    assert(bins.insert(10));
+    assert(bins.size() == 1);
+    assert(bins.contains(10));
+    assert(!bins.contains(11));
+
+    assert(bins.insert(20));
+    assert(bins.insert(30));
+    assert(bins.size() == 3);
+    assert(bins.contains(20) && bins.contains(30));
+}
+
+void test_quotient_bin_collection_capacity_limit()
+{
+    // a single bin, so all elements compete for the same slots
+    QuotientBinCollection<uint64_t, 1, 3> bins;
+    assert(bins.insert(10));
+    assert(bins.insert(20));
+    assert(bins.insert(30));
+    assert(!bins.insert(40));
+    assert(bins.remove(20));
+    assert(bins.insert(40));
+    assert(bins.contains(10) && bins.contains(30) && bins.contains(40) && !bins.contains(20));
+}
+
+void test_quotient_bin_collection_remainder_zero()
+{
+    // with a single bin the remainder is the permuted element, element(0, 0) has remainder 0
+    QuotientBinCollection<uint32_t, 1, 8> bins;
+    const uint32_t zero_remainder = bins.element(0, 0);
+    assert(!bins.contains(zero_remainder));
+    assert(bins.insert(zero_remainder));
+    assert(bins.contains(zero_remainder));
+    assert(bins.remove(zero_remainder));
+    assert(!bins.contains(zero_remainder));
+}
+
+void test_quotient_bin_collection_random_operations()
+{
+    QuotientBinCollection<uint32_t, 100, 16> collection;
+    std::unordered_multiset<uint32_t> std_collection;
+
+    std::srand(42);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 2000;
+
+        if (operation == 0)
+        {
+            if (collection.insert(value))
+            {
+                std_collection.insert(value);
+            }
+        }
+        else if (operation == 1)
+        {
+            int std_num_instances_removed = std_collection.erase(value);
+            int num_instances_removed = 0;
+            while (collection.remove(value))
+            {
+                ++num_instances_removed;
+            }
+            assert(num_instances_removed == std_num_instances_removed);
+        }
+        else
+        {
+            assert(collection.contains(value) == (std_collection.count(value) > 0));
+        }
+        assert(collection.size() == (int)std_collection.size());
+    }
+}
+
+void test_quotient_bins_in_backyard()
+{
+    constexpr int num_bins = 10;
+    constexpr int bin_capacity = 10;
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, 100, 1000, 20, 1000, 1000, 20,
+                          QuotientBinCollection<uint32_t, num_bins, bin_capacity>>
+        custom_set(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+    }
+}
+
+void test_quotient_bins_use_less_memory()
+{
+    // 2^16 bins leave 16 bit remainders for 32 bit keys
+    assert((QuotientBinCollection<uint32_t, 1 << 16, 8>::remainder_bits == 16));
+    assert((QuotientBinCollection<uint32_t, 1 << 16, 8>::size_in_bits() * 2 <=
+            SimpleBinCollection<uint32_t, 1 << 16, 8>::size_in_bits()));
+}
+
+void test_quotient_bin_collection_packed_across_words()
+{
+    // 64 bit keys with few bins leave remainders that are packed across word boundaries
+    using Collection = QuotientBinCollection<uint64_t, 10, 8>;
+    assert(Collection::packed_across_words);
+    Collection collection;
+    std::unordered_set<uint64_t> std_set;
+
+    std::srand(42);
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint64_t value = ((uint64_t)std::rand() << 32) ^ (std::rand() % 100);
+        if (std::rand() % 2)
+        {
+            if (collection.insert(value))
+            {
+                std_set.insert(value);
+            }
+        }
+        else
+        {
+            assert(collection.remove(value) == (std_set.erase(value) > 0));
+        }
+        assert(collection.size() == (int)std_set.size());
+        for (uint64_t elem : std_set)
+        {
+            assert(collection.contains(elem));
+        }
+    }
+}
+
+void test_quotient_bin_collection_for_each()
+{
+    // several fields per word and fields packed across words
+    QuotientBinCollection<uint32_t, 50, 4> small_remainders;
+    QuotientBinCollection<uint64_t, 10, 8> large_remainders;
+    std::unordered_set<uint64_t> small_std_set;
+    std::unordered_set<uint64_t> large_std_set;
+
+    std::srand(42);
+    for (int i = 0; i < 300; ++i)
+    {
+        const uint32_t value = std::rand();
+        if (small_remainders.insert(value))
+        {
+            small_std_set.insert(value);
+        }
+        if (large_remainders.insert(((uint64_t)value << 32) | i))
+        {
+            large_std_set.insert(((uint64_t)value << 32) | i);
+        }
+    }
+
+    std::unordered_set<uint64_t> elements;
+    small_remainders.for_each([&elements](uint32_t elem)
+                              { elements.insert(elem); });
+    assert(elements == small_std_set);
+    elements.clear();
+    large_remainders.for_each([&elements](uint64_t elem)
+                              { elements.insert(elem); });
+    assert(elements == large_std_set);
+}
@@ -0,0 +1,27 @@
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include "../src/seqlock_array.h"
+
+void test_seqlock_array_counters_of_written_stripes()
+{
+    SeqlockArray<uint32_t, 100> array;
+    static_assert(SeqlockArray<uint32_t, 100>::stripe_size == 16);
+    array.fill(7);
+    assert(std::as_const(array)[0] == 7 && std::as_const(array)[99] == 7);
+
+    const uint32_t first = array.read_begin(0);
+    const uint32_t second = array.read_begin(16);
+    // a write invalidates the reads of its stripe, but not those of other stripes
+    array[3] = 42;
+    assert(!array.read_valid(0, first));
+    assert(array.read_valid(16, second));
+    // reads through a const reference aren't writes
+    assert(std::as_const(array)[20] == 7);
+    assert(array.read_valid(16, second));
+
+    array.publish();
+    const uint32_t published = array.read_begin(0);
+    assert(published != first && std::as_const(array)[3] == 42);
+    assert(array.read_valid(0, published));
+}
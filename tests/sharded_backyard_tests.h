@@ -0,0 +1,202 @@
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <unordered_set>
+#include "../src/backyard.h"
+#include "../src/sharded_backyard.h"
+
+using TestShard = BackyardCuckooHashing<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20>;
+
+void test_mpsc_ring_order()
+{
+    MpscRing<int, 4> ring;
+    int item = 0;
+    assert(!ring.try_pop(item));
+    for (int i = 0; i < 4; ++i)
+    {
+        assert(ring.try_push(i));
+    }
+    assert(!ring.try_push(4)); // ring is full
+    for (int i = 0; i < 4; ++i)
+    {
+        assert(ring.try_pop(item) && item == i);
+    }
+    assert(!ring.try_pop(item));
+}
+
+void test_sharded_backyard_random_operations()
+{
+    ShardedBackyard<uint32_t, 4, TestShard> custom_set(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 5000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+    }
+}
+
+void test_sharded_backyard_batches_from_many_threads()
+{
+    ShardedBackyard<uint32_t, 4, TestShard> custom_set(10);
+    constexpr int num_threads = 4;
+    constexpr int elements_per_thread = 200;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&custom_set, t]()
+                             {
+            // insert and look up the own elements in one batch, operations on a key are applied in order
+            std::vector<Operation<uint32_t>> batch;
+            for (uint32_t i = 0; i < elements_per_thread; ++i)
+            {
+                batch.push_back({OperationType::insert, t * 1000 + i, false});
+                batch.push_back({OperationType::contains, t * 1000 + i, false});
+            }
+            custom_set.execute(batch);
+            for (std::size_t i = 1; i < batch.size(); i += 2)
+            {
+                assert(batch[i].result);
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < num_threads; ++t)
+    {
+        for (uint32_t i = 0; i < elements_per_thread; ++i)
+        {
+            assert(custom_set.contains(t * 1000 + i));
+        }
+    }
+}
+
+// shard that records the hash values of a few keys under the hash functions it was created with
+struct RecordingShard : TestShard
+{
+    static inline std::mutex mutex;
+    static inline std::vector<std::vector<uint32_t>> hash_values;
+
+    RecordingShard(int insert_loop_iterations) : TestShard(insert_loop_iterations)
+    {
+        std::vector<uint32_t> values;
+        for (uint32_t key = 0; key < 8; ++key)
+        {
+            values.push_back(cuckoo_tables_h[0].hash(key));
+            values.push_back(cuckoo_tables_h[1].hash(key));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        hash_values.push_back(values);
+    }
+};
+
+void test_sharded_backyard_shards_draw_distinct_hash_functions()
+{
+    {
+        // every shard is created by its own worker thread
+        ShardedBackyard<uint32_t, 4, RecordingShard> custom_set(10);
+    }
+    assert(RecordingShard::hash_values.size() == 4);
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        for (std::size_t j = i + 1; j < 4; ++j)
+        {
+            assert(RecordingShard::hash_values[i] != RecordingShard::hash_values[j]);
+        }
+    }
+}
+
+void test_sharded_backyard_hash_functions_only_depend_on_the_seed()
+{
+    // the order in which the workers create their shards differs between runs, the set of hash functions doesn't
+    auto draw = [](uint64_t seed)
+    {
+        RecordingShard::hash_values.clear();
+        {
+            ShardedBackyard<uint32_t, 4, RecordingShard> custom_set(10, {}, seed);
+        }
+        std::vector<std::vector<uint32_t>> hash_values = RecordingShard::hash_values;
+        std::sort(hash_values.begin(), hash_values.end());
+        return hash_values;
+    };
+    const std::vector<std::vector<uint32_t>> first = draw(7);
+    assert(draw(7) == first);
+    assert(draw(8) != first);
+}
+
+// shard whose constructor fails for the third shard and whose insert fails for the key 13
+struct ThrowingShard : TestShard
+{
+    static inline std::atomic<int> num_constructed = 0;
+
+    ThrowingShard(int insert_loop_iterations) : TestShard(insert_loop_iterations)
+    {
+        if (num_constructed.fetch_add(1) == 2)
+        {
+            throw std::runtime_error("Throwing Shard: construction failed");
+        }
+    }
+
+    void insert(const uint32_t &item)
+    {
+        if (item == 13)
+        {
+            throw std::runtime_error("Throwing Shard: insert failed");
+        }
+        TestShard::insert(item);
+    }
+};
+
+void test_sharded_backyard_passes_on_exceptions_of_shards()
+{
+    bool caught = false;
+    try
+    {
+        ShardedBackyard<uint32_t, 4, ThrowingShard> custom_set(10);
+    }
+    catch (const std::runtime_error &)
+    {
+        caught = true;
+    }
+    assert(caught);
+
+    // the third shard is only created once
+    ShardedBackyard<uint32_t, 4, ThrowingShard> custom_set(10);
+    caught = false;
+    try
+    {
+        custom_set.insert(13);
+    }
+    catch (const std::runtime_error &)
+    {
+        caught = true;
+    }
+    assert(caught);
+    // the workers keep running
+    custom_set.insert(14);
+    assert(custom_set.contains(14) && !custom_set.contains(13));
+}
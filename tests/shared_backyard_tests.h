@@ -0,0 +1,85 @@
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../src/shared_backyard.h"
+
+using SharedSet = SharedBackyard<uint32_t, 10, 10, 100, 1000, 20, 1000, 1000, 20>;
+
+void test_shared_backyard_reader_sees_writes()
+{
+    const std::string name = "/backyard_test_" + std::to_string(getpid());
+    SharedSet writer(name, 10);
+    // maps the segment a second time at another address
+    SharedSet reader(name);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+    for (int i = 0; i < 5000; ++i)
+    {
+        uint32_t value = std::rand() % 250;
+        if (std::rand() % 2)
+        {
+            writer.insert(value);
+            std_set.insert(value);
+        }
+        else
+        {
+            assert(writer.remove(value) == (std_set.erase(value) > 0));
+        }
+        assert(reader.contains(value) == (std_set.count(value) > 0));
+    }
+    assert(writer.size() == (int)std_set.size());
+
+    bool thrown = false;
+    try
+    {
+        reader.insert(1);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_shared_backyard_reader_process()
+{
+    const std::string name = "/backyard_test_" + std::to_string(getpid());
+    SharedSet writer(name, 10);
+    for (uint32_t i = 0; i < 150; ++i)
+    {
+        writer.insert(i);
+    }
+
+    const pid_t child = fork();
+    if (child == 0)
+    {
+        SharedSet reader(name);
+        bool correct = true;
+        for (uint32_t i = 0; i < 300; ++i)
+        {
+            correct = correct && reader.contains(i) == (i < 150);
+        }
+        _exit(correct ? 0 : 1);
+    }
+    int status;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+void test_shared_backyard_missing_segment()
+{
+    bool thrown = false;
+    try
+    {
+        SharedSet reader("/backyard_test_missing_segment");
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
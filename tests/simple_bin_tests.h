@@ -1,5 +1,7 @@
 #include <cassert>
 #include <cstdint>
+#include <algorithm>
+#include <vector>
 #include <unordered_set>
 #include "../src/simple_bin.h"
 
@@ -126,4 +128,85 @@ void test_bin_collection_random_operations()
         }
         assert(collection.size() == std_collection.size());
     }
-}
\ No newline at end of file
+}
+
+void test_bin_collection_two_choices_random_operations()
+{
+    SimpleBinCollection<uint32_t, 100, 4, 2> collection;
+    std::unordered_multiset<uint32_t> std_collection;
+
+    std::srand(42);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            if (collection.insert(value))
+            {
+                std_collection.insert(value);
+            }
+        }
+        else if (operation == 1)
+        {
+            int std_num_instances_removed = std_collection.erase(value);
+            int num_instances_removed = 0;
+            while (collection.remove(value))
+            {
+                ++num_instances_removed;
+            }
+            assert(num_instances_removed == std_num_instances_removed);
+        }
+        else
+        {
+            assert(collection.contains(value) == (std_collection.count(value) > 0));
+        }
+        assert(collection.size() == (int)std_collection.size());
+    }
+}
+
+void test_bin_collection_two_choices_fewer_overflows()
+{
+    SimpleBinCollection<uint32_t, 250, 4, 1> one_choice;
+    SimpleBinCollection<uint32_t, 250, 4, 2> two_choices;
+    int one_choice_overflows = 0;
+    int two_choices_overflows = 0;
+
+    // fill the bins up to a load factor of 0.9
+    for (uint32_t i = 0; i < 900; ++i)
+    {
+        one_choice_overflows += !one_choice.insert(i * 2654435761u);
+        two_choices_overflows += !two_choices.insert(i * 2654435761u);
+    }
+
+    assert(two_choices_overflows < one_choice_overflows);
+}
+
+void test_bin_collection_bulk_insert()
+{
+    SimpleBinCollection<uint32_t, 100, 4> sequential;
+    // copy, so both use the same hash function
+    SimpleBinCollection<uint32_t, 100, 4> parallel = sequential;
+    std::vector<uint32_t> keys;
+    std::srand(42);
+    // more keys than slots and some duplicates, so there are overflowing keys
+    for (int i = 0; i < 600; ++i)
+    {
+        keys.push_back(std::rand() % 500);
+    }
+
+    std::vector<uint32_t> sequential_overflow = sequential.bulk_insert(keys, 1);
+    std::vector<uint32_t> parallel_overflow = parallel.bulk_insert(keys, 4);
+
+    // the parallel fill is grouped by bin, but every bin sees its keys in input order
+    std::sort(sequential_overflow.begin(), sequential_overflow.end());
+    std::sort(parallel_overflow.begin(), parallel_overflow.end());
+    assert(sequential_overflow == parallel_overflow);
+    assert(parallel.size() == sequential.size());
+    for (uint32_t key : keys)
+    {
+        assert(parallel.contains(key) == sequential.contains(key));
+    }
+}
@@ -0,0 +1,58 @@
+#include <cassert>
+#include <array>
+#include <cstdint>
+#include <unordered_set>
+#include "../src/static_backyard.h"
+
+constexpr std::array<uint32_t, 300> static_backyard_test_keys()
+{
+    std::array<uint32_t, 300> keys{};
+    uint64_t state = 7;
+    for (uint32_t &key : keys)
+    {
+        // duplicates are possible and have to be ignored
+        key = splitmix64(state) % 1000;
+    }
+    return keys;
+}
+
+using StaticTestSet = StaticBackyard<uint32_t, 32, 8, 64>;
+// built by the compiler, a lookup that fails here doesn't compile
+static constexpr StaticTestSet static_test_set = StaticTestSet::build(static_backyard_test_keys());
+static_assert(static_test_set.contains(static_backyard_test_keys()[0]));
+static_assert(static_test_set.contains(static_backyard_test_keys()[299]));
+
+void test_static_backyard_contains()
+{
+    const std::array<uint32_t, 300> keys = static_backyard_test_keys();
+    std::unordered_set<uint32_t> std_set(keys.begin(), keys.end());
+
+    assert(static_test_set.size() == (int)std_set.size());
+    // 32 bins of 8 can't hold all keys
+    assert(static_test_set.backyard_size() > 0);
+    for (uint32_t value = 0; value < 2000; ++value)
+    {
+        assert(static_test_set.contains(value) == (std_set.count(value) > 0));
+    }
+}
+
+void test_static_backyard_build_at_runtime()
+{
+    const std::array<uint32_t, 300> keys = static_backyard_test_keys();
+    // the same seed gives the same set as the compiler built
+    const StaticTestSet set = StaticTestSet::build(keys);
+    assert(set.seed() == static_test_set.seed());
+    assert(set.backyard_size() == static_test_set.backyard_size());
+
+    // 16 slots can't hold the keys that don't fit into their bin
+    bool thrown = false;
+    try
+    {
+        StaticBackyard<uint32_t, 32, 8, 8>::build(keys);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
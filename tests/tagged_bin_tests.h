@@ -0,0 +1,167 @@
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include "../src/tagged_bin.h"
+#include "../src/backyard.h"
+
+// key that counts how often it is compared
+struct CountingKey
+{
+    static inline int comparisons = 0;
+    std::string value;
+
+    bool operator==(const CountingKey &other) const
+    {
+        ++comparisons;
+        return value == other.value;
+    }
+};
+
+template <>
+struct std::hash<CountingKey>
+{
+    std::size_t operator()(const CountingKey &key) const
+    {
+        return std::hash<std::string>{}(key.value);
+    }
+};
+
+void test_tagged_bin_insertion_and_removal()
+{
+    TaggedBin<std::string, 3> bin;
+    assert(bin.insert("a", 1));
+    assert(bin.insert("b", 1));
+    assert(bin.insert("c", 2));
+    assert(!bin.insert("d", 3));
+    assert(bin.size() == 3);
+
+    assert(bin.contains("a", 1) && bin.contains("b", 1) && bin.contains("c", 2));
+    // same key with a different tag is never compared
+    assert(!bin.contains("a", 2));
+
+    assert(bin.remove("b", 1));
+    assert(!bin.contains("b", 1));
+    assert(bin.insert("d", 3));
+    assert(bin.contains("d", 3));
+}
+
+void test_tagged_bin_collection_random_operations()
+{
+    TaggedBinCollection<std::string, 50, 20> collection;
+    std::unordered_multiset<std::string> std_collection;
+
+    std::srand(42);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        int operation = std::rand() % 3;
+        std::string value = "key_" + std::to_string(std::rand() % 1000);
+
+        if (operation == 0)
+        {
+            if (collection.insert(value))
+            {
+                std_collection.insert(value);
+            }
+        }
+        else if (operation == 1)
+        {
+            int std_num_instances_removed = std_collection.erase(value);
+            int num_instances_removed = 0;
+            while (collection.remove(value))
+            {
+                ++num_instances_removed;
+            }
+            assert(num_instances_removed == std_num_instances_removed);
+        }
+        else
+        {
+            assert(collection.contains(value) == (std_collection.count(value) > 0));
+        }
+        assert(collection.size() == (int)std_collection.size());
+    }
+}
+
+void test_tagged_bin_collection_avoids_key_comparisons()
+{
+    // a single bin that is full, so every lookup looks at 32 occupied slots
+    TaggedBinCollection<CountingKey, 1, 32> collection;
+    for (int i = 0; i < 32; ++i)
+    {
+        assert(collection.insert({"present_" + std::to_string(i)}));
+    }
+
+    CountingKey::comparisons = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        assert(!collection.contains({"absent_" + std::to_string(i)}));
+    }
+    // expected number of comparisons is 1000 * 32 / 256 = 125, without tags it would be 32000
+    assert(CountingKey::comparisons < 500);
+}
+
+void test_tagged_bins_in_backyard()
+{
+    constexpr int num_bins = 10;
+    constexpr int bin_capacity = 10;
+    BackyardCuckooHashing<uint32_t, num_bins, bin_capacity, 100, 1000, 20, 1000, 1000, 20,
+                          TaggedBinCollection<uint32_t, num_bins, bin_capacity>>
+        custom_set(10);
+    std::unordered_set<uint32_t> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        uint32_t value = std::rand() % 1000;
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+    }
+}
+
+void test_tagged_bins_in_backyard_with_string_keys()
+{
+    constexpr int num_bins = 20;
+    constexpr int bin_capacity = 16;
+    BackyardCuckooHashing<std::string, num_bins, bin_capacity, 100, 1000, 20, 1000, 1000, 20,
+                          TaggedBinCollection<std::string, num_bins, bin_capacity>>
+        custom_set(10);
+    std::unordered_set<std::string> std_set;
+
+    std::srand(42);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        int operation = std::rand() % 3;
+        std::string value = "key_" + std::to_string(std::rand() % 1000);
+
+        if (operation == 0)
+        {
+            custom_set.insert(value);
+            std_set.insert(value);
+        }
+        else if (operation == 1)
+        {
+            assert(custom_set.remove(value) == (std_set.erase(value) > 0));
+        }
+        else
+        {
+            assert(custom_set.contains(value) == (std_set.count(value) > 0));
+        }
+    }
+    assert(custom_set.size() == int(std_set.size()));
+}
@@ -1,11 +1,12 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <unordered_set>
 #include "../src/hash.h"
 
 // Test 1: Ensure the hash value is within the specified range
-void test_hash_set_range()
+void test_tornado_hash_set_range()
 {
     TornadoHash<uint32_t> hash_func;
     hash_func.set_range(100); // Set the range to 100
@@ -77,4 +78,27 @@ void test_hash_edge_cases()
         // Just ensure no crashes; optionally, print or log `hash_value` for inspection
         (void)hash_value; // Avoid unused variable warnings
     }
-}
\ No newline at end of file
+}
+
+// Test 6: Verify 64 bit keys and keys hashed by std::hash (e.g. strings) stay in range and are well spread
+void test_tornado_hash_wide_and_string_keys()
+{
+    TornadoHash<uint64_t> wide_hash;
+    wide_hash.set_range(1000);
+    TornadoHash<std::string> string_hash;
+    string_hash.set_range(1000);
+
+    std::unordered_set<uint32_t> wide_values;
+    std::unordered_set<uint32_t> string_values;
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        // keys that only differ in the top byte
+        uint32_t wide_value = wide_hash.hash(i << 56);
+        uint32_t string_value = string_hash.hash("key_" + std::to_string(i));
+        assert(wide_value < 1000 && string_value < 1000);
+        wide_values.insert(wide_value);
+        string_values.insert(string_value);
+    }
+    assert(wide_values.size() > 85 && string_values.size() > 85);
+    assert(string_hash.hash("key_1") == string_hash.hash(std::string("key_1")));
+}
@@ -0,0 +1,112 @@
+#include <cassert>
+#include <cstdint>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+#include "../src/workload.h"
+
+void test_distinct_keys()
+{
+    const DistinctKeys<uint32_t> keys(42);
+    const std::vector<uint32_t> all = keys.generate(0, 200000);
+    std::unordered_set<uint32_t> seen(all.begin(), all.end());
+    assert(seen.size() == all.size());
+
+    // the same keys for every split into ranges and in parallel
+    const std::vector<uint32_t> second_half = keys.generate(100000, 100000);
+    assert(std::equal(second_half.begin(), second_half.end(), all.begin() + 100000));
+    assert(generate_parallel<uint32_t>(keys, 0, all.size(), 3) == all);
+    assert(keys[123456] == all[123456]);
+
+    // reproducible from the seed, other keys for other seeds
+    assert(DistinctKeys<uint32_t>(42).generate(0, 100) == keys.generate(0, 100));
+    assert(DistinctKeys<uint32_t>(43).generate(0, 100) != keys.generate(0, 100));
+    // every index is a key of its own, also for 64 bit keys
+    const DistinctKeys<uint64_t> wide_keys(7);
+    assert(wide_keys[0] != wide_keys[1] && wide_keys[1] != wide_keys[uint64_t(1) << 40]);
+}
+
+void test_zipf_distribution()
+{
+    const int n = 1000;
+    const int num_samples = 200000;
+    for (double exponent : {0.0, 0.5, 0.99, 1.0, 1.5})
+    {
+        const ZipfDistribution zipf(n, exponent);
+        std::vector<int> counts(n, 0);
+        uint64_t state = 1;
+        for (int i = 0; i < num_samples; ++i)
+        {
+            const uint64_t rank = zipf(state);
+            assert(rank < uint64_t(n));
+            ++counts[rank];
+        }
+        // the most frequent ranks match 1 / (r + 1)^exponent / H(n, exponent)
+        double harmonic = 0;
+        for (int r = 1; r <= n; ++r)
+        {
+            harmonic += std::pow(r, -exponent);
+        }
+        for (int r = 0; r < 3; ++r)
+        {
+            const double expected = num_samples * std::pow(r + 1, -exponent) / harmonic;
+            assert(std::abs(counts[r] - expected) < 5 * std::sqrt(expected) + 1);
+        }
+    }
+
+    bool thrown = false;
+    try
+    {
+        ZipfDistribution(0, 1.0);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void test_lookup_stream()
+{
+    const uint64_t num_present = 10000;
+    const DistinctKeys<uint32_t> keys(3);
+    const std::vector<uint32_t> present = keys.generate(0, num_present);
+    const std::unordered_set<uint32_t> present_set(present.begin(), present.end());
+    const std::vector<uint32_t> absent = keys.generate(num_present, num_present);
+    const std::unordered_set<uint32_t> absent_set(absent.begin(), absent.end());
+
+    const LookupStream<DistinctKeys<uint32_t>> zipf_lookups(keys, num_present, num_present, 0.8,
+                                                            ZipfDistribution(num_present, 0.99), 5);
+    const std::vector<uint32_t> lookups = zipf_lookups.generate(0, 100000);
+    int hits = 0;
+    for (uint32_t key : lookups)
+    {
+        assert(present_set.contains(key) != absent_set.contains(key));
+        hits += present_set.contains(key);
+    }
+    assert(std::abs(hits - 80000) < 1000);
+    // ranges are independent of each other
+    assert(zipf_lookups.generate(50000, 10) ==
+           std::vector<uint32_t>(lookups.begin() + 50000, lookups.begin() + 50010));
+    assert(generate_parallel<uint32_t>(zipf_lookups, 0, lookups.size(), 4) == lookups);
+
+    // the same lookups of keys in memory
+    const std::vector<uint32_t> in_memory = keys.generate(0, 2 * num_present);
+    const LookupStream<std::span<const uint32_t>> span_lookups(in_memory, num_present, num_present, 0.8,
+                                                               ZipfDistribution(num_present, 0.99), 5);
+    assert(span_lookups.generate(0, 1000) == zipf_lookups.generate(0, 1000));
+
+    // 90% of the lookups go to 10% of the keys
+    const LookupStream<DistinctKeys<uint32_t>, HotSetDistribution> hot_lookups(
+        keys, num_present, 0, 1.0, HotSetDistribution(num_present, 0.1, 0.9), 5);
+    std::unordered_set<uint32_t> hot_keys;
+    for (uint32_t key : hot_lookups.generate(0, 100000))
+    {
+        assert(present_set.contains(key));
+        hot_keys.insert(key);
+    }
+    // all 1000 hot keys and a part of the cold ones (10000 draws from 9000 keys)
+    assert(hot_keys.size() > 1000 + 5000 && hot_keys.size() < 1000 + 7000);
+}
@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "../src/backyard_trace.h"
+
+// Reads a trace written by BackyardCuckooHashing::trace().write(path) (built with -DBACKYARD_TRACE) and prints
+// the eviction chain length of every insert, how often each length occurred, the inserts with the longest
+// chains and, with --timeline, every event.
+// usage: trace_dump <trace file> [--timeline]
+
+struct InsertSummary
+{
+    uint32_t insert_number;
+    uint32_t key = 0;
+    // displacements caused by the insert loop of the insert (the chain may continue in later inserts)
+    int chain_length = 0;
+    int bin_misses = 0;
+    int cdm_hits = 0;
+    int rebuilds = 0;
+    // false if the buffer dropped the begin of the insert
+    bool complete = false;
+};
+
+std::vector<InsertSummary> summarize(const std::vector<TraceEvent> &events)
+{
+    std::map<uint32_t, InsertSummary> inserts;
+    for (const TraceEvent &event : events)
+    {
+        InsertSummary &summary = inserts.try_emplace(event.insert_number, InsertSummary{event.insert_number})
+                                     .first->second;
+        switch (event.type)
+        {
+        case TraceEventType::insert_begin:
+            summary.key = event.key;
+            summary.complete = true;
+            break;
+        case TraceEventType::displacement:
+            ++summary.chain_length;
+            break;
+        case TraceEventType::bin_miss:
+            ++summary.bin_misses;
+            break;
+        case TraceEventType::cdm_hit:
+            ++summary.cdm_hits;
+            break;
+        case TraceEventType::queue_rebuild:
+        case TraceEventType::cdm_rebuild:
+        case TraceEventType::rehash:
+            ++summary.rebuilds;
+            break;
+        default:
+            break;
+        }
+    }
+    std::vector<InsertSummary> summaries;
+    for (const auto &[insert_number, summary] : inserts)
+    {
+        summaries.push_back(summary);
+    }
+    return summaries;
+}
+
+void print_timeline(const std::vector<TraceEvent> &events)
+{
+    std::cout << "insert,event,key,side,slot\n";
+    for (const TraceEvent &event : events)
+    {
+        std::cout << event.insert_number << "," << trace_event_name(event.type) << "," << event.key << ","
+                  << int(event.side) << ",";
+        if (event.type == TraceEventType::displacement || event.type == TraceEventType::cuckoo_placement)
+        {
+            std::cout << event.slot;
+        }
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <trace file> [--timeline]\n";
+        return 1;
+    }
+    std::vector<TraceEvent> events;
+    try
+    {
+        events = read_trace(argv[1]);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    if (argc > 2 && std::string(argv[2]) == "--timeline")
+    {
+        print_timeline(events);
+        return 0;
+    }
+
+    const std::vector<InsertSummary> summaries = summarize(events);
+    std::cout << "insert,key,chain_length,bin_misses,cdm_hits,rebuilds,complete\n";
+    std::map<int, int> chain_lengths;
+    for (const InsertSummary &summary : summaries)
+    {
+        std::cout << summary.insert_number << "," << summary.key << "," << summary.chain_length << ","
+                  << summary.bin_misses << "," << summary.cdm_hits << "," << summary.rebuilds << ","
+                  << summary.complete << "\n";
+        ++chain_lengths[summary.chain_length];
+    }
+
+    std::cerr << events.size() << " events of " << summaries.size() << " inserts\nchain length: inserts\n";
+    for (const auto &[length, count] : chain_lengths)
+    {
+        std::cerr << "  " << length << ": " << count << "\n";
+    }
+    std::vector<InsertSummary> longest = summaries;
+    std::sort(longest.begin(), longest.end(), [](const InsertSummary &a, const InsertSummary &b)
+              { return a.chain_length > b.chain_length; });
+    longest.resize(std::min<std::size_t>(longest.size(), 10));
+    std::cerr << "longest chains (insert, key, length):\n";
+    for (const InsertSummary &summary : longest)
+    {
+        std::cerr << "  " << summary.insert_number << ", " << summary.key << ", " << summary.chain_length << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include "tests/background_backyard_tests.h"
+#include "tests/backyard_trace_tests.h"
+#include "tests/backyard_tests.h"
+#include "tests/carter_wegman_hash_tests.h"
+#include "tests/cdm_tests.h"
+#include "tests/concurrent_backyard_tests.h"
+#include "tests/cow_array_tests.h"
+#include "tests/seqlock_array_tests.h"
+#include "tests/frozen_backyard_tests.h"
+#include "tests/optimistic_backyard_tests.h"
+#include "tests/permutation_hash_tests.h"
+#include "tests/planner_tests.h"
+#include "tests/queue_tests.h"
+#include "tests/quotient_bin_tests.h"
+#include "tests/sharded_backyard_tests.h"
+#include "tests/shared_backyard_tests.h"
+#include "tests/simple_bin_tests.h"
+#include "tests/static_backyard_tests.h"
+#include "tests/tagged_bin_tests.h"
+#include "tests/tornado_hash_tests.h"
+#include "tests/workload_tests.h"
+
+// runs all unit tests, a failing test aborts through assert
+int main()
+{
+    test_background_backyard_lookups_while_draining();
+    test_background_backyard_random_operations();
+    test_background_backyard_reports_lagging_drainer();
+    test_backyard_insert_and_contains();
+    test_backyard_remove();
+    test_backyard_overflow_handling();
+    test_backyard_alternating_operations();
+    test_backyard_reset_behavior();
+    test_backyard_random_operations();
+    test_backyard_adaptive_insert_loop_iterations();
+    test_backyard_adaptive_random_operations();
+    test_backyard_incremental_rehash();
+    test_backyard_rehash_on_sustained_queue_growth();
+    test_backyard_rehash_recovers_from_bad_hash_functions();
+    test_backyard_two_choice_bins();
+    test_backyard_build_from();
+    test_backyard_save_and_load();
+    test_backyard_snapshot();
+    test_backyard_snapshot_reads_dont_copy_chunks();
+    test_backyard_stats();
+    test_backyard_memory_usage();
+    test_trace_ring_keeps_last_events();
+    test_trace_ring_write_and_read();
+    test_backyard_trace();
+    test_carter_wegman_hash_set_range();
+    test_hash_randomize_parameters();
+    test_hash_hash_distribution();
+    test_hash_collision_rate();
+    test_cdm_insert_and_contains_three_times_checked();
+    test_cdm_insert_and_contains_two_times_checked();
+    test_cdm_reset();
+    test_collection_insert_and_contains();
+    test_collection_rebuild_trigger();
+    test_collection_recollection();
+    test_collection_empty();
+    test_collection_capacity();
+    test_cdm_duplicate_inserts();
+    test_collection_alternating_inserts_and_recollections();
+    test_collection_random_operations();
+    test_concurrent_backyard_random_operations();
+    test_concurrent_backyard_parallel_writers();
+    test_concurrent_backyard_adaptive_insert_loop_and_rehash();
+    test_cow_array_copies_share_chunks();
+    test_seqlock_array_counters_of_written_stripes();
+    test_frozen_backyard_contains();
+    test_frozen_backyard_empty_and_invalid_files();
+    test_frozen_backyard_corrupt_files();
+    test_optimistic_backyard_random_operations();
+    test_optimistic_backyard_readers_during_evictions();
+    test_permutation_hash_is_invertible();
+    test_permutation_hash_is_injective();
+    test_permutation_hash_randomize_parameters();
+    test_permutation_hash_from_seed();
+    test_planner_plan();
+    test_planned_backyard_holds_capacity();
+    test_queue_push_back();
+    test_queue_push_front();
+    test_queue_pop_front();
+    test_queue_contains();
+    test_queue_remove();
+    test_queue_empty();
+    test_queue_rebuild();
+    test_queue_random_operations();
+    test_queue_save_and_load();
+    test_queue_load_restores_positions();
+    test_quotient_bin_collection_insertion();
+    test_quotient_bin_collection_capacity_limit();
+    test_quotient_bin_collection_remainder_zero();
+    test_quotient_bin_collection_random_operations();
+    test_quotient_bins_in_backyard();
+    test_quotient_bins_use_less_memory();
+    test_quotient_bin_collection_packed_across_words();
+    test_quotient_bin_collection_for_each();
+    test_mpsc_ring_order();
+    test_sharded_backyard_random_operations();
+    test_sharded_backyard_batches_from_many_threads();
+    test_sharded_backyard_shards_draw_distinct_hash_functions();
+    test_sharded_backyard_hash_functions_only_depend_on_the_seed();
+    test_sharded_backyard_passes_on_exceptions_of_shards();
+    test_shared_backyard_reader_sees_writes();
+    test_shared_backyard_reader_process();
+    test_shared_backyard_missing_segment();
+    test_simple_bin_initial_state();
+    test_simple_bin_insertion();
+    test_simple_bin_removal();
+    test_simple_bin_capacity_limit();
+    test_simple_bin_reuse_deleted_slots();
+    test_simple_bin_remove_all();
+    test_bin_collection_insertion();
+    test_bin_collection_random_operations();
+    test_bin_collection_two_choices_random_operations();
+    test_bin_collection_two_choices_fewer_overflows();
+    test_bin_collection_bulk_insert();
+    test_static_backyard_contains();
+    test_static_backyard_build_at_runtime();
+    test_tagged_bin_insertion_and_removal();
+    test_tagged_bin_collection_random_operations();
+    test_tagged_bin_collection_avoids_key_comparisons();
+    test_tagged_bins_in_backyard();
+    test_tagged_bins_in_backyard_with_string_keys();
+    test_tornado_hash_set_range();
+    test_randomize_parameters();
+    test_consistent_hashing();
+    test_hash_uniqueness();
+    test_hash_edge_cases();
+    test_tornado_hash_wide_and_string_keys();
+    test_distinct_keys();
+    test_zipf_distribution();
+    test_lookup_stream();
+    std::cout << "all tests passed\n";
+    return 0;
+}